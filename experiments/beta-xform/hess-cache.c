@@ -0,0 +1,163 @@
+/*
+ * hess-cache.c
+ *
+ * Assemble the whole dim x dim matrix of the transfer operator in
+ * the Hessenberg basis at once, instead of element by element, and
+ * optionally keep it on disk, so that other programs, and later runs,
+ * at the same K can just load it. Include after psi.c; the midpoints
+ * must already be set up, as for hess().
+ *
+ * The rows are independent, and are spread over all cores with
+ * OpenMP, if compiled with -fopenmp. Only the upper-Hessenberg part,
+ * j >= i-1, is computed; the rest is zero.
+ *
+ * With sequence_midpoints() no longer quadratic, assembly is fast
+ * (a few milliseconds at dim=500), so the disk cache is off unless
+ * the environment variable HESS_CACHE names a directory for it. The
+ * files are named by K and dim, and by a checksum of the midpoints
+ * used, since those also depend on the precision that big_midpoints()
+ * was run at. The matrix is very sparse, a handful of entries per
+ * row, so only the nonzero entries are stored.
+ *
+ * October 2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HESS_MAGIC 0x48455353  /* "HESS" */
+
+typedef struct
+{
+	uint32_t magic;
+	int32_t dim;
+	double K;
+	uint64_t check;
+	int64_t nnz;
+} hess_header;
+
+typedef struct
+{
+	int32_t i;
+	int32_t j;
+	double val;
+} hess_entry;
+
+/* FNV-1a over the midpoints that the first dim rows depend on. */
+static uint64_t hess_checksum(int dim)
+{
+	uint64_t h = 14695981039346656037ULL;
+	const unsigned char *p = (const unsigned char *) midpoints;
+	size_t len = (dim+2) * sizeof(double);
+	for (size_t i=0; i<len; i++)
+	{
+		h ^= p[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+static void hess_cache_name(char *name, size_t len, const char *dir,
+                            double K, int dim, uint64_t check)
+{
+	snprintf(name, len, "%s/hess-K%.17g-N%d-%016llx.dat", dir, K, dim,
+	         (unsigned long long) check);
+}
+
+static bool hess_cache_load(const char *name, double K, int dim,
+                            uint64_t check, double *matrix)
+{
+	FILE *fh = fopen(name, "r");
+	if (NULL == fh) return false;
+
+	hess_header hdr;
+	bool ok = (1 == fread(&hdr, sizeof(hdr), 1, fh));
+	ok = ok && HESS_MAGIC == hdr.magic && dim == hdr.dim &&
+	     K == hdr.K && check == hdr.check;
+
+	if (ok) memset(matrix, 0, dim * dim * sizeof(double));
+	for (int64_t k=0; ok && k<hdr.nnz; k++)
+	{
+		hess_entry e;
+		ok = (1 == fread(&e, sizeof(e), 1, fh));
+		ok = ok && 0 <= e.i && e.i < dim && 0 <= e.j && e.j < dim;
+		if (ok) matrix[e.i*dim + e.j] = e.val;
+	}
+	fclose(fh);
+	return ok;
+}
+
+static void hess_cache_save(const char *name, double K, int dim,
+                            uint64_t check, const double *matrix)
+{
+	/* Write to a temp file, and move it into place when complete,
+	 * so that a reader never sees half a matrix. */
+	char tmp[4200];
+	snprintf(tmp, sizeof(tmp), "%s.%d", name, (int) getpid());
+	FILE *fh = fopen(tmp, "w");
+	if (NULL == fh)
+	{
+		fprintf(stderr, "hess cache: can't write %s: %s\n", tmp, strerror(errno));
+		return;
+	}
+
+	hess_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = HESS_MAGIC;
+	hdr.dim = dim;
+	hdr.K = K;
+	hdr.check = check;
+	for (int k=0; k<dim*dim; k++)
+		if (0.0 != matrix[k]) hdr.nnz++;
+
+	bool ok = (1 == fwrite(&hdr, sizeof(hdr), 1, fh));
+	for (int k=0; ok && k<dim*dim; k++)
+	{
+		if (0.0 == matrix[k]) continue;
+		hess_entry e;
+		e.i = k / dim;
+		e.j = k % dim;
+		e.val = matrix[k];
+		ok = (1 == fwrite(&e, sizeof(e), 1, fh));
+	}
+	if (fclose(fh)) ok = false;
+
+	if (ok) ok = (0 == rename(tmp, name));
+	if (false == ok)
+	{
+		fprintf(stderr, "hess cache: can't save %s\n", name);
+		unlink(tmp);
+	}
+}
+
+/*
+ * Fill matrix, of dim x dim doubles, row-major, with hess(K, i, j).
+ * Returns true if it came out of the cache.
+ */
+bool hess_matrix(double K, double *matrix, int dim)
+{
+	const char *dir = getenv("HESS_CACHE");
+	bool cache = (NULL != dir && 0 != *dir);
+
+	uint64_t check = 0;
+	char name[4096];
+	if (cache)
+	{
+		check = hess_checksum(dim);
+		hess_cache_name(name, sizeof(name), dir, K, dim, check);
+		if (hess_cache_load(name, K, dim, check, matrix)) return true;
+	}
+
+#pragma omp parallel for schedule(dynamic, 8)
+	for (int i=0; i<dim; i++)
+	{
+		int js = (0 < i) ? i-1 : 0;
+		for (int j=0; j<js; j++) matrix[i*dim+j] = 0.0;
+		for (int j=js; j<dim; j++) matrix[i*dim+j] = hess(K, i, j);
+	}
+
+	if (cache) hess_cache_save(name, K, dim, check, matrix);
+	return false;
+}
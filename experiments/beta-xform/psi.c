@@ -71,57 +71,90 @@ void find_midpoints(double K, int maxn)
 	}
 }
 
+static int by_midpoint(const void *a, const void *b)
+{
+	int ia = *(const int *) a;
+	int ib = *(const int *) b;
+	if (midpoints[ia] < midpoints[ib]) return -1;
+	if (midpoints[ib] < midpoints[ia]) return 1;
+	return ia - ib;
+}
+
 void sequence_midpoints(double K, int maxn)
 {
-	/* Now sort them in sequential order. Use a super-stupid sort algo. */
-	mid_sequence[0] = 0;
+	/* Sort them in sequential order. Ties go to the lowest index. */
+	int *order = (int *) malloc(maxn * sizeof(int));
+	for (int i=0; i< maxn; i++) order[i] = i;
+	qsort(order, maxn, sizeof(int), by_midpoint);
 
-	for (int j=1; j< maxn; j++)
+	/* mid_sequence lists the distinct midpoints strictly between
+	 * 0 and K, in increasing order. */
+	mid_sequence[0] = 0;
+	int j = 1;
+	double prev = 0.0;
+	for (int s=0; s< maxn; s++)
 	{
-		double mid = midpoints[mid_sequence[j-1]];
-		double lub = K;
-		int idx = maxn;
-		for (int i=1; i< maxn; i++)
-		{
-			if (mid < midpoints[i] && midpoints[i] < lub) {
-				lub = midpoints[i]; idx = i;
-			}
-		}
-		mid_sequence[j] = idx;
-
-//		printf("%d	%d	%g\n", j, idx, lub);
+		int i = order[s];
+		if (0 == i) continue;
+		if (midpoints[i] <= prev || K <= midpoints[i]) continue;
+		mid_sequence[j++] = i;
+		prev = midpoints[i];
 	}
+	for (; j< maxn; j++) mid_sequence[j] = maxn;
 
 	printf("#\n#------------------------\n#\n");
 
-	/* Compute the pointers to the lower and the upper ends */
+	/* Compute the pointers to the lower and the upper ends: for
+	 * midpoint j, the nearest of the earlier midpoints 1..j-1 on
+	 * either side. Walk j downwards, deleting each midpoint from a
+	 * list in sorted order once it's done, so that its neighbors in
+	 * the list are always the ones wanted. Of several equal
+	 * midpoints, the one with the lowest index is the head of the
+	 * group, and is used; it is also the last to be deleted. */
+	int *pos = (int *) malloc(maxn * sizeof(int));
+	int *prv = (int *) malloc(maxn * sizeof(int));
+	int *nxt = (int *) malloc(maxn * sizeof(int));
+	int *head = (int *) malloc(maxn * sizeof(int));
+	for (int s=0; s< maxn; s++)
+	{
+		pos[order[s]] = s;
+		prv[s] = s-1;
+		nxt[s] = s+1;
+		head[s] = s;
+		if (0 < s && midpoints[order[s-1]] == midpoints[order[s]])
+			head[s] = head[s-1];
+	}
+
 	lower_sequence[0] = 0;
 	lower_sequence[1] = 0;
 	upper_sequence[0] = 1;
 	upper_sequence[1] = 1;
-	for (int j=2; j< maxn; j++)
+	for (int j=maxn-1; 2 <= j; j--)
 	{
-		double low = 0.0;
-		double hi = K;
+		int s = pos[j];
+
+		int p = prv[head[s]];
 		int lidx = 0;
+		if (0 <= p && 0.0 < midpoints[order[p]])
+			lidx = order[head[p]];
+
+		int n = nxt[s];
 		int uidx = 1;
-		for (int i=1; i< j; i++)
-		{
-			if (low < midpoints[i] && midpoints[i] < midpoints[j])
-			{
-				low = midpoints[i];
-				lidx = i;
-			}
-			if (midpoints[i] < hi && midpoints[j] < midpoints[i])
-			{
-				hi = midpoints[i];
-				uidx = i;
-			}
-		}
+		if (n < maxn && midpoints[order[n]] < K)
+			uidx = order[n];
+
 		lower_sequence[j] = lidx;
 		upper_sequence[j] = uidx;
-//		printf("%d	%g	%g	%g\n", j, low, midpoints[j], hi);
-	}	
+
+		if (0 <= prv[s]) nxt[prv[s]] = nxt[s];
+		if (nxt[s] < maxn) prv[nxt[s]] = prv[s];
+	}
+
+	free(order);
+	free(pos);
+	free(prv);
+	free(nxt);
+	free(head);
 }
 
 /* Return the n'th wave function at the value of x. */
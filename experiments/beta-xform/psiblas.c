@@ -12,9 +12,9 @@
 #define NOMAIN 1
 #include "psi.c"
 #include "psibig.c"
+#include "hess-cache.c"
 
-#include <lapacke.h>
-#include <cblas.h>
+#include "mtx.h"
 
 /*
  * Eigenvalue and eigenvector problem. -- LAPACK version.
@@ -32,6 +32,7 @@
  * Lapack, Eigenvalues only, use: HSEQR
  * Eigenvalues an eigenvectors: HSEQR TREVC
  * DHSEQR for double precision, ZHSEQR for complex double precision.
+ * Called through mtx_d_hseqr(), in ../continued-frobenius/mtx-lapack.c
  *
  * This does eigenvalues only, right now.
  */
@@ -39,35 +40,15 @@ void eigen(double K, int dim)
 {
 	int mxi = MAXN-1;
 mxi = dim;
-	double* matrix = malloc(mxi*mxi*sizeof(double));
+	mtx_d* matrix = mtx_d_new(mxi, mxi);
 
-	// This fills matrix in row-major order.
-	int idx = 0;
-	for (int i=0; i< mxi; i++)
-	{
-		for (int j=0; j< mxi; j++)
-		{
-			double h = hess(K, i, j);
-			matrix[idx] = h;
-			idx++;
-		}
-	}
-
-	/*
-	 * lapack_int LAPACKE_dhseqr(int matrix_layout,
-	 *                           char job, char  compz,
-	 *                           lapack_int n,
-	 *                           lapack_int ilo, lapack_int ihi, double* h,
-	 *                           lapack_int ldh, double* wr, double* wi,
-	 *                           double* z, lapack_int ldz );
-	 */
+	// This fills matrix in row-major order, which is how mtx_d
+	// stores it.
+	hess_matrix(K, matrix->a, mxi);
 
 	double* wr = malloc(mxi* sizeof(double));
 	double* wi = malloc(mxi* sizeof(double));
-	double* z = malloc(mxi*mxi* sizeof(double));
-	lapack_int info;
-	info = LAPACKE_dhseqr(LAPACK_ROW_MAJOR, 'E', 'N', mxi, 1, mxi, matrix,
-	                      mxi, wr, wi, z, mxi);
+	int info = mtx_d_hseqr(matrix, wr, wi);
 	printf("# info=%d  K=%g\n", info, K);
 	double avg = 0.0;
 	double cnt = 0.0;
@@ -80,6 +61,10 @@ mxi = dim;
 		else if (0.5 < mag && mag < 0.999) {avg += mag; cnt += 1; }
 	}
 	printf("#\n# average radius= %g cnt= %g\n#\n", avg/cnt, cnt);
+
+	free(wi);
+	free(wr);
+	mtx_d_free(matrix);
 }
 
 
@@ -10,6 +10,7 @@
 #define NOMAIN 1
 #include "psi.c"
 #include "psibig.c"
+#include "hess-cache.c"
 
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_eigen.h>
@@ -32,16 +33,7 @@ mxi = dim;
 	double* matrix = malloc(mxi*mxi*sizeof(double));
 
 	// Do we need this, or the transpose ??? Does it matter?
-	int idx = 0;
-	for (int i=0; i< mxi; i++)
-	{
-		for (int j=0; j< mxi; j++)
-		{
-			double h = hess(K, i, j);
-			matrix[idx] = h;
-			idx++;
-		}
-	}
+	hess_matrix(K, matrix, mxi);
 
 	// Magic incantation to diagonalize the matrix.
 	gsl_matrix_view m = gsl_matrix_view_array (matrix, mxi, mxi);
@@ -5,24 +5,65 @@
  * Gnu Multiple-precision library.
  *
  * Linas Vepstas July 2006
+ *
+ * The values are computed in parallel, by the sweep driver in sweep.c.
+ * If a store is named, each value is stored in it as soon as it is
+ * computed, so that the store doubles as a checkpoint; values that
+ * are already in the store, to at least the requested precision, are
+ * not computed again. With --resume, they are not printed again,
+ * either.
+ * October 2026
  */
 
 #include <gmp.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
 #include "mp-misc.h"
 #include "mp-zeta.h"
+#include "sweep.h"
 
 /* ==================================================================== */
 
+static int resume = 0;
+
+static void zeta_compute (mpf_t val, int n, int prec)
+{
+	fp_zeta (val, n, prec);
+}
+
+static void zeta_print (int n, mpf_t val, double secs)
+{
+	/* When resuming, don't repeat what was printed last time. */
+	if (secs < 0.0 && resume) return;
+
+	printf ("%d\t", n);
+	mpf_sub_ui (val, val, 1);
+	fp_prt ("", val);
+	printf ("\t%d\n", (int) secs);
+	fflush (stdout);
+}
+
 int main (int argc, char * argv[])
 {
-	if (argc < 4)
+	sweep_opts opts;
+	memset (&opts, 0, sizeof(opts));
+	sweep_options (&argc, argv, &opts);
+
+	char * progname = argv[0];
+	if (1 < argc && 0 == strcmp (argv[1], "--resume"))
 	{
-		fprintf (stderr, "Usage: %s <ndigits> <start> <end>\n", argv[0]); 
+		resume = 1;
+		argv++;
+		argc--;
+	}
+
+	if (argc < 4 || (resume && argc < 5))
+	{
+		fprintf (stderr, "Usage: %s [-j <nworkers>] [--shard=<k>/<N>] [--resume] <ndigits> <start> <end> [<store>]\n", progname);
+		fprintf (stderr, "\t--resume requires a store\n");
 		exit (1);
 	}
 
@@ -41,25 +82,12 @@ int main (int argc, char * argv[])
 	
 	/* set the precision (number of binary bits) */
 	mpf_set_default_prec (bits);
-	
-	mpf_t term;
-	mpf_init (term);
 
-	int n;
-	for (n=nstart; n<nend; n++)
-	{
-		time_t start = time(0);
-		fp_zeta (term, n, prec);
-		time_t end = time(0);
-		int elapsed = end-start;
-		
-		printf ("%d\t", n);
-		mpf_sub_ui (term, term, 1);
-		fp_prt ("", term);
-		printf ("\t%d\n",elapsed);
-		fflush (stdout);
-	}
-	
-	return 0;
+	/* Values already in the store are skipped; the rest are spread
+	 * over the worker processes. */
+	opts.prec = prec;
+	opts.store = (4 < argc) ? argv[4] : NULL;
+	opts.compute = zeta_compute;
+	opts.print = zeta_print;
+	return sweep_run (&opts, nstart, nend) ? 1 : 0;
 }
-
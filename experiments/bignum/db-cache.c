@@ -21,123 +21,88 @@
  *
  */
 
-#include <db_185.h>
-#include <errno.h>
-#include <fcntl.h>
-#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/stat.h>
-#include <sys/types.h>
 
 #include <gmp.h>
 #include "db-cache.h"
+#include "fp-store.h"
+
+/*
+ * These used to open the Berkeley DB file, and close it again, for
+ * every value, and store the values as decimal strings. They are now
+ * a front end to fp-store.c: each store is opened the first time it
+ * is used, and stays open until the program exits. Existing DB files
+ * are migrated to a store the first time they are used.
+ */
 
-void fp_cache_put (const char * dbname, const mpf_t val, int idx, int nprec)
+#define MAX_OPEN_STORES 16
+
+static struct
+{
+	char *dbname;
+	fp_store *st;
+	int writable;
+} open_stores[MAX_OPEN_STORES];
+static int num_open_stores = 0;
+static pthread_mutex_t store_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+/* Return the store for dbname, opened for writing if asked. */
+static fp_store * session_store (const char *dbname, int writable)
 {
-	DB *db;
+	int i;
+	for (i=0; i<num_open_stores; i++)
+	{
+		if (strcmp (dbname, open_stores[i].dbname)) continue;
+		if (open_stores[i].writable || !writable) return open_stores[i].st;
+
+		/* Opened read-only before; re-open for writing. */
+		fp_store_close (open_stores[i].st);
+		open_stores[i].st = fp_store_open_db (dbname, 1);
+		open_stores[i].writable = 1;
+		return open_stores[i].st;
+	}
 
-	db = dbopen (dbname, O_RDWR|O_EXCL, 
-	             S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH, DB_HASH, NULL);
+	fp_store *st = fp_store_open_db (dbname, writable);
+	if (NULL == st) return NULL;
 
-	if (!db && (ENOENT == errno))
+	/* Too many open at once; give up the last one. */
+	if (MAX_OPEN_STORES <= num_open_stores)
 	{
-		db = dbopen (dbname, O_RDWR|O_CREAT|O_EXCL, 
-	             S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH, DB_HASH, NULL);
+		i = --num_open_stores;
+		fp_store_close (open_stores[i].st);
+		free (open_stores[i].dbname);
 	}
+	open_stores[i].dbname = strdup (dbname);
+	open_stores[i].st = st;
+	open_stores[i].writable = writable;
+	num_open_stores ++;
+	return st;
+}
 
-	if (!db)
+void fp_cache_put (const char * dbname, const mpf_t val, int idx, int nprec)
+{
+	pthread_mutex_lock (&store_mtx);
+	fp_store *st = session_store (dbname, 1);
+	if (!st)
 	{
-		int norr = errno;
 		fprintf (stderr, "Error: cannot open the cache file, idx=%d\n", idx);
-		fprintf (stderr, "\t(%d) %s\n", norr, strerror(norr));
+		pthread_mutex_unlock (&store_mtx);
 		return;
 	}
-
-	/* Save the value data to the file */
-	DBT vkey;
-	char buf[50];
-	sprintf (buf, "val[%d]", idx);
-	vkey.data = &buf;
-	vkey.size = strlen(buf)+1;
-
-	/* the printf is floating point */
-	size_t allo = nprec*sizeof(char)+50;
-	char *vstr= malloc (allo);
-	gmp_snprintf (vstr, allo, "%.*Fg", nprec, val);
-
-	DBT vdat;
-	vdat.data = vstr;
-	vdat.size = strlen(vstr)+1;
-
-	db->put (db, &vkey, &vdat, 0);
-	free (vstr);
-
-	/* Save the precision data to the file */
-	DBT pkey;
-	sprintf (buf, "prec[%d]", idx);
-	pkey.data = &buf;
-	pkey.size = strlen(buf)+1;
-
-	DBT pdat;
-	pdat.data = &nprec;
-	pdat.size = sizeof(int);
-
-	db->put (db, &pkey, &pdat, 0);
-	db->close (db);
+	fp_store_put (st, val, idx, nprec);
+	pthread_mutex_unlock (&store_mtx);
 }
 
 int fp_cache_get (const char * dbname, mpf_t val, int idx, int nprec)
 {
-	DB *db;
-
-	db = dbopen (dbname, O_RDONLY, 0, DB_HASH, NULL);
-
-	if (!db) return 0;
-
-	/* Look for the stored precision of data in the file */
-	DBT pkey;
-	char buf[50];
-	sprintf (buf, "prec[%d]", idx);
-	pkey.data = &buf;
-	pkey.size = strlen(buf)+1;
-
-	DBT pdat;
-
-	/* if not key, then nothing */
-	int rc = db->get (db, &pkey, &pdat, 0);
-	if (rc)
-	{
-		db->close (db);
-		return 0;
-	}
-
-	/* check to see if we have enough precision */
-	int have_prec = *((int *)pdat.data);
-	if (nprec > have_prec)
-	{
-		db->close (db);
-		return 0;
-	}
-
-	/* Get the value data from the file */
-	DBT vkey;
-	sprintf (buf, "val[%d]", idx);
-	vkey.data = &buf;
-	vkey.size = strlen(buf)+1;
-
-	rc = db->get (db, &vkey, &pdat, 0);
-	if (rc)
-	{
-		db->close (db);
-		return 0;
-	}
-
-	// printf ("found nprec=%d for %d = %s\n", have_prec, idx, pdat.data);
-	mpf_set_str (val, pdat.data, 10);
-	
-	db->close (db);
+	pthread_mutex_lock (&store_mtx);
+	fp_store *st = session_store (dbname, 0);
+	int have_prec = 0;
+	if (st) have_prec = fp_store_get (st, val, idx, nprec);
+	pthread_mutex_unlock (&store_mtx);
 	return have_prec;
 }
 
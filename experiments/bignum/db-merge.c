@@ -5,6 +5,7 @@
  * The value with the highest precision is kept.
  *
  * Linas Vepstas July 2006
+ * Ported to fp-store -- October 2026
  */
 
 #include <stdio.h>
@@ -13,13 +14,13 @@
 #include <math.h>
 #include <gmp.h>
 
-#include "db-cache.h"
+#include "fp-store.h"
 #include "mp-misc.h"
 
 int
 main (int argc, char * argv[])
 {
-	if (argc<5)
+	if (argc<6)
 	{
 		fprintf (stderr,"Usage: %s <out-db> <in-dba> <in-dbb> <from> <to>\n", argv[0]);
 		exit (1);
@@ -39,14 +40,23 @@ main (int argc, char * argv[])
 
 	printf ("Merging %s and %s into %s from %d to %d\n", dbina, dbinb, dbout, from, too);
 
+	fp_store *sta = fp_store_open_db (dbina, 0);
+	fp_store *stb = fp_store_open_db (dbinb, 0);
+	fp_store *stout = fp_store_open_db (dbout, 1);
+	if (!stout)
+	{
+		fprintf (stderr, "Error: cannot open %s\n", dbout);
+		exit (1);
+	}
+
 	mpf_t vala, valb;
 	mpf_init (vala);
 	mpf_init (valb);
 	int n;
 	for (n=from; n<= too; n++)
 	{
-		int preca = fp_cache_get (dbina, vala, n, 10);
-		int precb = fp_cache_get (dbinb, valb, n, 10);
+		int preca = sta ? fp_store_get (sta, vala, n, 10) : 0;
+		int precb = stb ? fp_store_get (stb, valb, n, 10) : 0;
 
 		if (0 >= preca && 0 >= precb) continue;
 		
@@ -54,7 +64,7 @@ main (int argc, char * argv[])
 		{
 			if (strcmp (dbina, dbout))
 			{
-				fp_cache_put (dbout, vala, n, preca);
+				fp_store_put (stout, vala, n, preca);
 				printf ("%d to %d from %s\t", n, preca, dbina);
 				fp_prt ("", vala);
 				printf ("\n");
@@ -64,12 +74,15 @@ main (int argc, char * argv[])
 		{
 			if (strcmp (dbinb, dbout))
 			{
-				fp_cache_put (dbout, valb, n, precb);
+				fp_store_put (stout, valb, n, precb);
 				printf ("%d to %d from %s\t", n, precb, dbinb);
 				fp_prt ("", valb);
 				printf ("\n");
 			}
 		}
 	}
+	fp_store_close (sta);
+	fp_store_close (stb);
+	fp_store_close (stout);
 	return 0;
 }
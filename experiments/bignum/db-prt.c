@@ -12,7 +12,10 @@
 #include <math.h>
 #include <gmp.h>
 
-#include "db-cache.h"
+#include "fp-store.h"
+
+/* Values are read from the store this many at a time. */
+#define CHUNK 256
 
 int
 main (int argc, char * argv[])
@@ -33,16 +36,30 @@ main (int argc, char * argv[])
 	/* set the precision (number of binary bits) */
 	mpf_set_default_prec (bits);
 
+	fp_store *st = fp_store_open_db (db, 0);
+	if (!st)
+	{
+		fprintf (stderr, "Error: cannot open %s\n", db);
+		exit (1);
+	}
+
 	printf ("printout of %s up to n=%d\n", db, maxidx);
 
-	mpf_t val;
-	mpf_init (val);
+	mpf_t vals[CHUNK];
+	int precs[CHUNK];
 	int n;
+	for (n=0; n<CHUNK; n++) mpf_init (vals[n]);
 	int lastprec=-1;
 	int lastn = 0;
 	for (n=from; n<= maxidx; n++)
 	{
-		int prec = fp_cache_get (db, val, n, 10);
+		if (0 == (n-from) % CHUNK)
+		{
+			int hi = n + CHUNK;
+			if (maxidx+1 < hi) hi = maxidx+1;
+			fp_store_get_range (st, vals, precs, n, hi, 10);
+		}
+		int prec = precs[(n-from) % CHUNK];
 		if (prec != lastprec)
 		{
 			if (-1 != lastprec)
@@ -68,5 +85,6 @@ main (int argc, char * argv[])
 	{
 		printf ("range %d : %d is missing\n", lastn, n-1);
 	}
+	fp_store_close (st);
 	return 0;
 }
@@ -0,0 +1,446 @@
+/*
+ * fp-store.c
+ *
+ * Persistent store for pre-computed bignum values.
+ * See fp-store.h for an overview.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <db_185.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <gmp.h>
+#include "fp-store.h"
+
+#define FP_STORE_MAGIC "FPSTORE1"
+#define FP_RECORD_MAGIC 0x46505231   /* "FPR1" */
+
+/* File header; the records follow. */
+typedef struct
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t limb_bytes;      /* sizeof(mp_limb_t) */
+	char     pad[48];
+} fp_file_header;
+
+/* One value. The |size| limbs follow directly. */
+typedef struct
+{
+	uint32_t magic;           /* FP_RECORD_MAGIC */
+	int32_t  idx;
+	int32_t  nprec;           /* decimal places */
+	int32_t  size;            /* _mp_size: limbs, negative if val < 0 */
+	int64_t  exp;             /* _mp_exp */
+	uint64_t check;           /* of the fields above, and the limbs */
+} fp_record;
+
+struct fp_store_s
+{
+	int fd;
+	int writable;
+	char *map;
+	size_t maplen;
+	size_t scanned;           /* file offset of the first unindexed record */
+
+	/* Offset of the best record for each index, or zero. */
+	size_t *off;
+	int *prec;
+	int cap;
+	int maxidx;
+};
+
+/* ==================================================================== */
+
+static size_t record_len (const fp_record *rec)
+{
+	return sizeof(fp_record) + abs(rec->size) * sizeof(mp_limb_t);
+}
+
+/* FNV-1a; just enough to catch records cut short. */
+static uint64_t record_check (const fp_record *rec)
+{
+	fp_record tmp = *rec;
+	tmp.check = 0;
+
+	uint64_t h = 0xcbf29ce484222325ULL;
+	const unsigned char *p = (const unsigned char *) &tmp;
+	for (size_t i=0; i<sizeof(tmp); i++)
+	{
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+
+	const mp_limb_t *limb = (const mp_limb_t *) (rec+1);
+	for (int i=0; i<abs(rec->size); i++)
+	{
+		h ^= (uint64_t) limb[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static void grow_index (fp_store *st, int idx)
+{
+	if (idx < st->cap) return;
+	int cap = 2*st->cap;
+	if (cap <= idx) cap = idx + 1024;
+	st->off = realloc (st->off, cap * sizeof(size_t));
+	st->prec = realloc (st->prec, cap * sizeof(int));
+	memset (&st->off[st->cap], 0, (cap - st->cap) * sizeof(size_t));
+	memset (&st->prec[st->cap], 0, (cap - st->cap) * sizeof(int));
+	st->cap = cap;
+}
+
+/* Map any records appended since the last scan, and index them.
+ * Stops at the first record that is incomplete. Returns the size
+ * of the file. */
+static size_t scan (fp_store *st)
+{
+	struct stat sb;
+	if (fstat (st->fd, &sb)) return st->scanned;
+	size_t size = sb.st_size;
+
+	if (st->maplen < size)
+	{
+		if (st->map) munmap (st->map, st->maplen);
+		st->map = mmap (NULL, size, PROT_READ, MAP_SHARED, st->fd, 0);
+		if (MAP_FAILED == st->map)
+		{
+			st->map = NULL;
+			st->maplen = 0;
+			return st->scanned;
+		}
+		st->maplen = size;
+	}
+
+	/* Don't look past the end of the file, even if it is mapped;
+	 * a torn record may have been cut off since. */
+	size_t end = (size < st->maplen) ? size : st->maplen;
+	size_t off = st->scanned;
+	while (off + sizeof(fp_record) <= end)
+	{
+		const fp_record *rec = (const fp_record *) (st->map + off);
+		if (FP_RECORD_MAGIC != rec->magic) break;
+		if (end < off + record_len (rec)) break;
+		if (record_check (rec) != rec->check) break;
+
+		if (0 <= rec->idx)
+		{
+			grow_index (st, rec->idx);
+			if (st->prec[rec->idx] <= rec->nprec)
+			{
+				st->off[rec->idx] = off;
+				st->prec[rec->idx] = rec->nprec;
+			}
+			if (st->maxidx < rec->idx) st->maxidx = rec->idx;
+		}
+		off += record_len (rec);
+	}
+	st->scanned = off;
+	return size;
+}
+
+/* ==================================================================== */
+
+fp_store * fp_store_open (const char *path, int writable)
+{
+	int fd = open (path, writable ? O_RDWR|O_CREAT : O_RDONLY,
+	               S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+	if (fd < 0) return NULL;
+
+	/* A new file gets its header; take the lock, in case some other
+	 * process is creating it at the same time. */
+	fp_file_header hdr;
+	if (writable)
+	{
+		flock (fd, LOCK_EX);
+		struct stat sb;
+		fstat (fd, &sb);
+		if (0 == sb.st_size)
+		{
+			memset (&hdr, 0, sizeof(hdr));
+			memcpy (hdr.magic, FP_STORE_MAGIC, 8);
+			hdr.version = 1;
+			hdr.limb_bytes = sizeof(mp_limb_t);
+			if (sizeof(hdr) != write (fd, &hdr, sizeof(hdr)))
+			{
+				int norr = errno;
+				flock (fd, LOCK_UN);
+				close (fd);
+				errno = norr;
+				return NULL;
+			}
+		}
+		flock (fd, LOCK_UN);
+	}
+
+	if (sizeof(hdr) != pread (fd, &hdr, sizeof(hdr), 0) ||
+	    memcmp (hdr.magic, FP_STORE_MAGIC, 8) ||
+	    sizeof(mp_limb_t) != hdr.limb_bytes)
+	{
+		close (fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	fp_store *st = calloc (1, sizeof(fp_store));
+	st->fd = fd;
+	st->writable = writable;
+	st->scanned = sizeof(fp_file_header);
+	st->maxidx = -1;
+	scan (st);
+	return st;
+}
+
+void fp_store_close (fp_store *st)
+{
+	if (NULL == st) return;
+	if (st->map) munmap (st->map, st->maplen);
+	close (st->fd);
+	free (st->off);
+	free (st->prec);
+	free (st);
+}
+
+/* Same name substitution as in the brat raster files: replace the
+ * extension, if any. */
+static void store_name (char *full, size_t len, const char *name)
+{
+	snprintf (full, len, "%s", name);
+	char *slash = strrchr (full, '/');
+	char *dot = strrchr (slash ? slash : full, '.');
+	if (dot) *dot = 0;
+	strncat (full, ".fps", len - strlen(full) - 1);
+}
+
+fp_store * fp_store_open_db (const char *dbname, int writable)
+{
+	char path[4096];
+	store_name (path, sizeof(path), dbname);
+
+	/* If there's no store yet, but there is an old DB, migrate it. */
+	if (0 == access (path, F_OK) || access (dbname, R_OK))
+		return fp_store_open (path, writable);
+
+	fp_store *st = fp_store_open (path, 1);
+	if (NULL == st) return NULL;
+	int n = fp_store_migrate (st, dbname);
+	fprintf (stderr, "fp_store: migrated %d values from %s to %s\n",
+	         n, dbname, path);
+	if (writable) return st;
+
+	fp_store_close (st);
+	return fp_store_open (path, 0);
+}
+
+/* ==================================================================== */
+
+static const fp_record * lookup (fp_store *st, int idx)
+{
+	if (idx < 0 || st->cap <= idx || 0 == st->off[idx]) return NULL;
+	return (const fp_record *) (st->map + st->off[idx]);
+}
+
+static void get_record (mpf_t val, const fp_record *rec)
+{
+	/* Point a read-only mpf at the limbs in the mapping, and copy. */
+	__mpf_struct src;
+	src._mp_prec = abs(rec->size);
+	src._mp_size = rec->size;
+	src._mp_exp = rec->exp;
+	src._mp_d = (mp_limb_t *) (rec+1);
+	mpf_set (val, &src);
+}
+
+int fp_store_get (fp_store *st, mpf_t val, int idx, int nprec)
+{
+	const fp_record *rec = lookup (st, idx);
+
+	/* Maybe some other process has stored it since. */
+	if (NULL == rec || rec->nprec < nprec)
+	{
+		scan (st);
+		rec = lookup (st, idx);
+	}
+	if (NULL == rec || rec->nprec < nprec) return 0;
+
+	get_record (val, rec);
+	return rec->nprec;
+}
+
+int fp_store_get_range (fp_store *st, mpf_t *vals, int *precs,
+                        int lo, int hi, int nprec)
+{
+	scan (st);
+
+	int found = 0;
+	for (int n=lo; n<hi; n++)
+	{
+		const fp_record *rec = lookup (st, n);
+		precs[n-lo] = 0;
+		if (NULL == rec || rec->nprec < nprec) continue;
+
+		get_record (vals[n-lo], rec);
+		precs[n-lo] = rec->nprec;
+		found ++;
+	}
+	return found;
+}
+
+int fp_store_max_index (fp_store *st)
+{
+	scan (st);
+	return st->maxidx;
+}
+
+/* ==================================================================== */
+
+static size_t put_record (char *buf, const mpf_t val, int idx, int nprec)
+{
+	fp_record *rec = (fp_record *) buf;
+	memset (rec, 0, sizeof(fp_record));
+	rec->magic = FP_RECORD_MAGIC;
+	rec->idx = idx;
+	rec->nprec = nprec;
+	rec->size = val->_mp_size;
+	rec->exp = val->_mp_exp;
+	memcpy (rec+1, val->_mp_d, abs(rec->size) * sizeof(mp_limb_t));
+	rec->check = record_check (rec);
+	return record_len (rec);
+}
+
+/* Append buf to the end of the file, holding the lock. */
+static void append (fp_store *st, const char *buf, size_t len)
+{
+	if (!st->writable)
+	{
+		fprintf (stderr, "Error: fp_store is read-only\n");
+		return;
+	}
+
+	flock (st->fd, LOCK_EX);
+
+	/* If a writer died half-way through a record, cut it off;
+	 * otherwise it would hide everything that follows. */
+	size_t size = scan (st);
+	if (st->scanned < size)
+	{
+		if (ftruncate (st->fd, st->scanned)) {}
+		munmap (st->map, st->maplen);
+		st->map = NULL;
+		st->maplen = 0;
+	}
+
+	size_t done = 0;
+	while (done < len)
+	{
+		ssize_t rc = pwrite (st->fd, buf + done, len - done, st->scanned + done);
+		if (rc <= 0)
+		{
+			int norr = errno;
+			fprintf (stderr, "Error: cannot write the fp_store\n");
+			fprintf (stderr, "\t(%d) %s\n", norr, strerror(norr));
+			break;
+		}
+		done += rc;
+	}
+
+	flock (st->fd, LOCK_UN);
+	scan (st);
+}
+
+void fp_store_put (fp_store *st, const mpf_t val, int idx, int nprec)
+{
+	char *buf = malloc (sizeof(fp_record) + abs(val->_mp_size) * sizeof(mp_limb_t));
+	size_t len = put_record (buf, val, idx, nprec);
+	append (st, buf, len);
+	free (buf);
+}
+
+void fp_store_put_range (fp_store *st, mpf_t *vals, int lo, int hi, int nprec)
+{
+	size_t len = 0;
+	for (int n=lo; n<hi; n++)
+		len += sizeof(fp_record) + abs(vals[n-lo]->_mp_size) * sizeof(mp_limb_t);
+
+	char *buf = malloc (len);
+	size_t off = 0;
+	for (int n=lo; n<hi; n++)
+		off += put_record (buf + off, vals[n-lo], n, nprec);
+	append (st, buf, off);
+	free (buf);
+}
+
+/* ==================================================================== */
+/* Migration from the Berkeley DB files written by fp_cache_put().
+ * These hold a key "prec[n]" with the precision, as an int, and a
+ * key "val[n]" with the value, as a decimal string. */
+
+int fp_store_migrate (fp_store *st, const char *dbname)
+{
+	DB *db = dbopen (dbname, O_RDONLY, 0, DB_HASH, NULL);
+	if (!db) return -1;
+
+	/* First pass: the precisions. */
+	int cap = 0;
+	int *precs = NULL;
+	DBT key, dat;
+	int rc = db->seq (db, &key, &dat, R_FIRST);
+	while (0 == rc)
+	{
+		int idx;
+		if (1 == sscanf (key.data, "prec[%d]", &idx) && 0 <= idx &&
+		    sizeof(int) == dat.size)
+		{
+			if (cap <= idx)
+			{
+				int ncap = idx + 1024;
+				precs = realloc (precs, ncap * sizeof(int));
+				memset (&precs[cap], 0, (ncap - cap) * sizeof(int));
+				cap = ncap;
+			}
+			memcpy (&precs[idx], dat.data, sizeof(int));
+		}
+		rc = db->seq (db, &key, &dat, R_NEXT);
+	}
+
+	/* Second pass: the values. */
+	int nvals = 0;
+	mpf_t val;
+	mpf_init (val);
+	rc = db->seq (db, &key, &dat, R_FIRST);
+	while (0 == rc)
+	{
+		int idx;
+		if (1 == sscanf (key.data, "val[%d]", &idx) &&
+		    0 <= idx && idx < cap && 0 < precs[idx])
+		{
+			int nprec = precs[idx];
+			mpf_set_prec (val, (mp_bitcnt_t) (nprec * log(10.0) / log(2.0)) + 64);
+			mpf_set_str (val, dat.data, 10);
+			fp_store_put (st, val, idx, nprec);
+			nvals ++;
+		}
+		rc = db->seq (db, &key, &dat, R_NEXT);
+	}
+
+	mpf_clear (val);
+	free (precs);
+	db->close (db);
+	return nvals;
+}
+
+/* ========================== END OF FILE ============= */
@@ -0,0 +1,98 @@
+/*
+ * fp-store.h
+ *
+ * Persistent store for pre-computed bignum values.
+ *
+ * The successor to db-cache.c. That opened and closed a Berkeley DB
+ * for every single value, and stored each one as a decimal string,
+ * so that loading ten thousand values at ten thousand digits spent
+ * more time in dbopen() and in mpf_set_str() than in arithmetic.
+ *
+ * A store is a single file of records, appended one after another.
+ * Each record holds an index n, the decimal precision it was computed
+ * to, and the value as raw GMP limbs plus exponent, with a checksum.
+ * The file is mmap'ed, and stays open for the whole session; reading
+ * a value is a copy of its limbs. A value may be stored more than
+ * once; the one with the highest precision wins.
+ *
+ * Records are only ever appended, and writers take an flock() on the
+ * file while appending, so any number of processes may read a store
+ * while others write to it. A reader sees records appended after it
+ * opened the store the next time it misses. A record cut short by a
+ * crash fails its checksum, and is ignored. A store handle must not
+ * be shared between threads without a lock.
+ *
+ * The limbs are stored in native byte order, and native limb size;
+ * the files are not portable between 32 and 64-bit machines.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __FP_STORE_H__
+#define __FP_STORE_H__
+
+#include <gmp.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+typedef struct fp_store_s fp_store;
+
+/**
+ * fp_store_open -- map the store in the file path. If writable is
+ * set, the file is created if it does not exist. Returns NULL, with
+ * errno set, if the file can't be opened or isn't a store.
+ */
+fp_store * fp_store_open (const char *path, int writable);
+
+/**
+ * fp_store_open_db -- open the store that replaces the Berkeley DB
+ * file dbname, i.e. the same name with the extension changed to
+ * .fps. If there is no such store yet, but there is a DB file, the
+ * DB is migrated into a new store first.
+ */
+fp_store * fp_store_open_db (const char *dbname, int writable);
+
+void fp_store_close (fp_store *st);
+
+/**
+ * fp_store_get -- look up the value for index idx. Returns the
+ * number of decimal places it is good to, if that is at least
+ * nprec, and sets val; else returns zero, and leaves val alone.
+ */
+int fp_store_get (fp_store *st, mpf_t val, int idx, int nprec);
+
+/** fp_store_put -- save val, good to nprec decimal places. */
+void fp_store_put (fp_store *st, const mpf_t val, int idx, int nprec);
+
+/**
+ * fp_store_get_range -- look up all of the values for indexes
+ * lo <= n < hi at once. For each n, vals[n-lo] and precs[n-lo] are
+ * set as fp_store_get() would (precs is zero for missing values).
+ * Returns the number of values found.
+ */
+int fp_store_get_range (fp_store *st, mpf_t *vals, int *precs,
+                        int lo, int hi, int nprec);
+
+/**
+ * fp_store_put_range -- save vals[n-lo] for lo <= n < hi, all good
+ * to nprec places, in one append.
+ */
+void fp_store_put_range (fp_store *st, mpf_t *vals, int lo, int hi, int nprec);
+
+/** Largest index in the store, or -1 if the store is empty. */
+int fp_store_max_index (fp_store *st);
+
+/**
+ * fp_store_migrate -- copy all of the values in the Berkeley DB
+ * file dbname, as written by fp_cache_put(), into the store. Returns
+ * the number of values copied, or -1 if the DB can't be opened.
+ */
+int fp_store_migrate (fp_store *st, const char *dbname);
+
+#ifdef  __cplusplus
+};
+#endif
+
+#endif /* __FP_STORE_H__ */
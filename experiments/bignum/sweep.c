@@ -0,0 +1,390 @@
+/*
+ * sweep.c
+ *
+ * Parallel driver for sweeps over an index range.
+ * See sweep.h for an overview.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gmp.h>
+#include "fp-store.h"
+#include "sweep.h"
+
+/* ==================================================================== */
+
+void sweep_options (int *argc, char *argv[], sweep_opts *opts)
+{
+	if (opts->nshards < 1)
+	{
+		opts->shard = 0;
+		opts->nshards = 1;
+	}
+
+	int i, j = 1;
+	for (i=1; i<*argc; i++)
+	{
+		char *arg = argv[i];
+		if (!strcmp (arg, "-j") && i+1 < *argc)
+			opts->nworkers = atoi (argv[++i]);
+		else if (!strncmp (arg, "--shard=", 8))
+			sscanf (arg+8, "%d/%d", &opts->shard, &opts->nshards);
+		else
+			argv[j++] = arg;
+	}
+	argv[j] = NULL;
+	*argc = j;
+
+	if (opts->nworkers < 0) opts->nworkers = 0;
+	if (opts->nshards < 1) opts->nshards = 1;
+	if (opts->shard < 0 || opts->nshards <= opts->shard) opts->shard = 0;
+}
+
+/* ==================================================================== */
+/* The cost model. Every value computed is logged, as a line
+ * "n seconds prec", in a file next to the store. The cost of a value
+ * that was computed before (maybe to a lower precision, by a sweep
+ * that then got killed) is taken to be what it was then; for other
+ * values, a power law, fit to the logged costs, is used. */
+
+typedef struct
+{
+	double *secs;
+	int cap;
+	double a, p;              /* log(secs) = a + p * log(n) */
+	int fitted;               /* zero until there is some data */
+} cost_model;
+
+static void cost_name (char *full, size_t len, const char *store)
+{
+	snprintf (full, len, "%s", store);
+	char *slash = strrchr (full, '/');
+	char *dot = strrchr (slash ? slash : full, '.');
+	if (dot) *dot = 0;
+	strncat (full, ".cost", len - strlen(full) - 1);
+}
+
+static void cost_load (cost_model *cm, const char *path, int nend, int prec)
+{
+	cm->cap = nend;
+	cm->secs = calloc (nend, sizeof(double));
+
+	/* Until there's data, assume the cost grows like n. */
+	cm->a = 0.0;
+	cm->p = 1.0;
+	cm->fitted = 0;
+
+	FILE *fp = fopen (path, "r");
+	if (NULL == fp) return;
+
+	double sx=0, sy=0, sxx=0, sxy=0;
+	int npts = 0;
+	int n, p;
+	double secs;
+	while (3 == fscanf (fp, "%d %lf %d", &n, &secs, &p))
+	{
+		if (p != prec || n < 1 || secs <= 0.0) continue;
+		if (n < nend) cm->secs[n] = secs;
+
+		double x = log (n);
+		double y = log (secs);
+		sx += x;
+		sy += y;
+		sxx += x*x;
+		sxy += x*y;
+		npts ++;
+	}
+	fclose (fp);
+
+	double det = npts*sxx - sx*sx;
+	if (npts < 2 || fabs (det) < 1e-12) return;
+	cm->p = (npts*sxy - sx*sy) / det;
+	cm->a = (sy - cm->p * sx) / npts;
+	cm->fitted = 1;
+}
+
+static double cost_predict (const cost_model *cm, int n)
+{
+	if (0 <= n && n < cm->cap && 0.0 < cm->secs[n]) return cm->secs[n];
+	if (n < 1) n = 1;
+	return exp (cm->a + cm->p * log (n));
+}
+
+static const cost_model *sort_model;
+
+static int by_cost (const void *a, const void *b)
+{
+	double ca = cost_predict (sort_model, *(const int *) a);
+	double cb = cost_predict (sort_model, *(const int *) b);
+	if (ca > cb) return -1;
+	if (ca < cb) return 1;
+	return *(const int *) b - *(const int *) a;
+}
+
+/* ==================================================================== */
+
+/* The queue of pending indexes, shared by the workers. */
+typedef struct
+{
+	int next;
+	int count;
+	int items[];
+} sweep_queue;
+
+/* Sent up the pipe by a worker, for each value it finishes. */
+typedef struct
+{
+	int n;
+	double secs;
+} sweep_msg;
+
+static double now (void)
+{
+	struct timeval tv;
+	gettimeofday (&tv, NULL);
+	return tv.tv_sec + 1.0e-6 * tv.tv_usec;
+}
+
+static void worker (const sweep_opts *opts, const char *store,
+                    sweep_queue *q, int wfd)
+{
+	/* Each worker needs its own file handle, so that its flock()
+	 * excludes the others. */
+	fp_store *st = fp_store_open_db (store, 1);
+	if (NULL == st) _exit (1);
+
+	mpf_t val;
+	mpf_init (val);
+	while (1)
+	{
+		int i = __atomic_fetch_add (&q->next, 1, __ATOMIC_RELAXED);
+		if (q->count <= i) break;
+
+		sweep_msg msg;
+		msg.n = q->items[i];
+		double start = now();
+		opts->compute (val, msg.n, opts->prec);
+		msg.secs = now() - start;
+
+		fp_store_put (st, val, msg.n, opts->prec);
+		if (sizeof(msg) != write (wfd, &msg, sizeof(msg))) break;
+	}
+	mpf_clear (val);
+	fp_store_close (st);
+	_exit (0);
+}
+
+int sweep_run (const sweep_opts *opts, int nstart, int nend)
+{
+	if (nend <= nstart) return 0;
+	int nshards = (opts->nshards < 1) ? 1 : opts->nshards;
+
+	int nworkers = opts->nworkers;
+	if (nworkers < 1) nworkers = sysconf (_SC_NPROCESSORS_ONLN);
+	if (nworkers < 1) nworkers = 1;
+
+	/* Until the results are in, every value counts as missing. All of
+	 * the failure paths go to out, which frees whatever was set up. */
+	int nmissing = nend - nstart;
+	int made_tmp = 0;
+	fp_store *st = NULL;
+	cost_model cm;
+	cm.secs = NULL;
+	int *mine = NULL;
+	char *cached = NULL;
+	char *done = NULL;
+	double *secs = NULL;
+	sweep_queue *q = MAP_FAILED;
+	size_t qlen = 0;
+	mpf_t val;
+	mpf_init (val);
+	char costname[4096];
+	costname[0] = 0;
+
+	/* Without a store, the results still go through one, so that
+	 * they can get back from the workers. */
+	char tmpname[] = "/tmp/sweep-XXXXXX.fps";
+	const char *store = opts->store;
+	if (NULL == store)
+	{
+		int fd = mkstemps (tmpname, 4);
+		if (fd < 0)
+		{
+			perror ("sweep: cannot create a temp store");
+			goto out;
+		}
+		close (fd);
+		made_tmp = 1;
+		store = tmpname;
+	}
+
+	st = fp_store_open_db (store, 1);
+	if (NULL == st)
+	{
+		fprintf (stderr, "sweep: cannot open %s: %s\n", store, strerror (errno));
+		goto out;
+	}
+
+	cost_name (costname, sizeof(costname), store);
+	cost_load (&cm, costname, nend, opts->prec);
+
+	/* This run's share, in increasing order of n. Counting down from
+	 * the top, every nshards'th index goes to the same shard. */
+	int nmine = 0;
+	mine = malloc ((nend - nstart) * sizeof(int));
+	cached = calloc (nend - nstart, 1);
+	done = calloc (nend - nstart, 1);
+	secs = calloc (nend - nstart, sizeof(double));
+	if (NULL == cm.secs || NULL == mine || NULL == cached ||
+	    NULL == done || NULL == secs)
+	{
+		fprintf (stderr, "sweep: out of memory for %d values\n", nend - nstart);
+		goto out;
+	}
+
+	int n;
+	for (n=nstart; n<nend; n++)
+		if ((nend-1-n) % nshards == opts->shard) mine[nmine++] = n;
+
+	/* The ones already in the store are done. */
+	qlen = sizeof(sweep_queue) + nmine * sizeof(int);
+	q = mmap (NULL, qlen, PROT_READ | PROT_WRITE,
+	          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == q)
+	{
+		perror ("sweep: cannot map the work queue");
+		goto out;
+	}
+	q->next = 0;
+	q->count = 0;
+	double predicted = 0.0;
+	int i;
+	for (i=0; i<nmine; i++)
+	{
+		n = mine[i];
+		if (fp_store_get (st, val, n, opts->prec))
+		{
+			cached[n-nstart] = 1;
+			continue;
+		}
+		q->items[q->count++] = n;
+		predicted += cost_predict (&cm, n);
+	}
+
+	/* Most expensive first, so that the workers finish together. */
+	sort_model = &cm;
+	qsort (q->items, q->count, sizeof(int), by_cost);
+
+	fprintf (stderr, "sweep: %d of %d values to compute, on %d workers\n",
+	         q->count, nmine, nworkers);
+	if (cm.fitted)
+		fprintf (stderr, "sweep: cost ~ n^%g; expect about %g secs\n",
+		         cm.p, predicted / nworkers);
+
+	int pfd[2];
+	if (pipe (pfd))
+	{
+		perror ("sweep: pipe");
+		goto out;
+	}
+
+	/* Don't let the workers inherit unwritten output. */
+	fflush (stdout);
+	fflush (stderr);
+
+	int nkids = 0;
+	if (nworkers > q->count) nworkers = q->count;
+	for (i=0; i<nworkers; i++)
+	{
+		pid_t pid = fork ();
+		if (0 == pid)
+		{
+			close (pfd[0]);
+			worker (opts, store, q, pfd[1]);
+		}
+		if (0 < pid) nkids ++;
+	}
+	close (pfd[1]);
+
+	/* Print the results in order, as soon as all of the ones before
+	 * them are done. */
+	FILE *cost = fopen (costname, "a");
+	int emit = 0;
+	while (1)
+	{
+		sweep_msg msg;
+		ssize_t rc = read (pfd[0], &msg, sizeof(msg));
+		if (rc < 0 && EINTR == errno) continue;
+		if (sizeof(msg) == rc)
+		{
+			done[msg.n-nstart] = 1;
+			secs[msg.n-nstart] = msg.secs;
+			if (cost)
+			{
+				fprintf (cost, "%d %g %d\n", msg.n, msg.secs, opts->prec);
+				fflush (cost);
+			}
+		}
+
+		for (; emit < nmine; emit++)
+		{
+			n = mine[emit];
+			if (!cached[n-nstart] && !done[n-nstart]) break;
+			if (NULL == opts->print) continue;
+			if (0 == fp_store_get (st, val, n, opts->prec)) continue;
+			opts->print (n, val, cached[n-nstart] ? -1.0 : secs[n-nstart]);
+		}
+		if (rc <= 0) break;
+	}
+	close (pfd[0]);
+	if (cost) fclose (cost);
+
+	for (i=0; i<nkids; i++)
+	{
+		int status;
+		wait (&status);
+	}
+
+	/* Anything a crashed worker was holding is lost. */
+	nmissing = 0;
+	for (; emit < nmine; emit++)
+	{
+		n = mine[emit];
+		if (!cached[n-nstart] && !done[n-nstart])
+		{
+			fprintf (stderr, "sweep: n=%d was not computed\n", n);
+			nmissing ++;
+			continue;
+		}
+		if (opts->print && fp_store_get (st, val, n, opts->prec))
+			opts->print (n, val, cached[n-nstart] ? -1.0 : secs[n-nstart]);
+	}
+
+out:
+	mpf_clear (val);
+	if (MAP_FAILED != q) munmap (q, qlen);
+	if (st) fp_store_close (st);
+	free (mine);
+	free (cached);
+	free (done);
+	free (secs);
+	free (cm.secs);
+	if (made_tmp)
+	{
+		unlink (tmpname);
+		if (costname[0]) unlink (costname);
+	}
+	return nmissing;
+}
+
+/* ========================== END OF FILE ============= */
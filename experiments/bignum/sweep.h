@@ -0,0 +1,73 @@
+/*
+ * sweep.h
+ *
+ * Parallel driver for sweeps over an index range, such as filling
+ * in zeta(n) for n = 2 to 10000, where each value is independent of
+ * the others, and takes minutes to compute.
+ *
+ * The values that are not yet in the value store (see fp-store.h),
+ * to at least the requested precision, are handed out to a pool of
+ * worker processes, most expensive first. The cost of each value is
+ * predicted from the costs observed for earlier values, which are
+ * kept in a log next to the store. Each worker writes its results
+ * straight into the store, so a sweep that is interrupted picks up
+ * where it left off. Results are printed in order of n, no matter in
+ * which order they are finished.
+ *
+ * Worker processes are used, rather than threads, because the
+ * anant functions keep global caches, and are not thread-safe.
+ *
+ * Several machines can share one sweep: with --shard=k/N, this run
+ * does only its share of the indexes, the k'th of N. The shares are
+ * interleaved, so that each gets a fair share of the expensive ones.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __SWEEP_H__
+#define __SWEEP_H__
+
+#include <gmp.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/** Compute the value for index n, to prec decimal places. */
+typedef void sweep_compute_fn (mpf_t val, int n, int prec);
+
+/**
+ * Print the result for index n. secs is the time it took, or -1 if
+ * it was already in the store.
+ */
+typedef void sweep_print_fn (int n, mpf_t val, double secs);
+
+typedef struct
+{
+	int prec;                 /* decimal places */
+	int nworkers;             /* worker processes; 0 for all cores */
+	int shard;                /* this run does the shard'th share ... */
+	int nshards;              /* ... of nshards */
+	const char *store;        /* value store name; NULL for a temp file */
+	sweep_compute_fn *compute;
+	sweep_print_fn *print;    /* may be NULL */
+} sweep_opts;
+
+/**
+ * sweep_options -- strip "-j N" and "--shard=k/N" out of argv, the
+ * same way that the brat renderers do, and set them in opts.
+ */
+void sweep_options (int *argc, char *argv[], sweep_opts *opts);
+
+/**
+ * sweep_run -- compute the values for nstart <= n < nend. Set the
+ * default mpf precision before calling. Returns the number of values
+ * that could not be computed (e.g. a worker crashed); zero on success.
+ */
+int sweep_run (const sweep_opts *opts, int nstart, int nend);
+
+#ifdef  __cplusplus
+};
+#endif
+
+#endif /* __SWEEP_H__ */
@@ -67,6 +67,48 @@ class SinaiRay
       int sphere_hits;  // how many times ray bounced off sphere
 };
 
+/* ==================================== */
+// A packet of RAY_PACKET SinaiRays, stored by component rather than
+// by ray, so that the same step can be taken for all of them at once
+// with SIMD instructions. Load() fills the first n lanes from an
+// array of rays; the rest are copies of the first, marked inactive.
+// Store() copies the results back.
+
+#define RAY_PACKET 8
+
+class RayPacket
+{
+   public:
+      void Load (SinaiRay *, int n);
+      void Store (SinaiRay *);
+   public:
+      int n;
+      double px[RAY_PACKET], py[RAY_PACKET], pz[RAY_PACKET];
+      double dx[RAY_PACKET], dy[RAY_PACKET], dz[RAY_PACKET];
+      double distance[RAY_PACKET];
+      int last_wall[RAY_PACKET];
+      int bounces[6][RAY_PACKET];
+      int sphere_hits[RAY_PACKET];
+      int active[RAY_PACKET];
+};
+
+/* ==================================== */
+// Counter-based random numbers: the n'th uniform deviate in [0,1)
+// of the stream named by seed. Since it depends on nothing else,
+// a ray that is handed its own n gets the same numbers no matter
+// which thread traces it, or in what order.
+
+static inline double
+ray_uniform (unsigned long seed, unsigned long n)
+{
+   // splitmix64
+   unsigned long z = seed + (n+1) * 0x9e3779b97f4a7c15UL;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+   z ^= z >> 31;
+   return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
 /* ==================================== */
 // The class SinaiBox defines the boundry conditions, the max
 // iterations, the shape of the actual box.
@@ -76,6 +118,11 @@ class SinaiRay
 //
 // The TraceToroid() method performs ray-tracing using periodic
 // toroidial boundary conditions.
+//
+// The TracePacketBox() and TracePacketToroid() methods do the same
+// for a packet of rays at a time, giving the same results, bit for
+// bit. TraceMany() traces an array of rays, a packet at a time,
+// spreading the packets over all cores if compiled with -fopenmp.
 
 class SinaiBox
 {
@@ -83,6 +130,9 @@ class SinaiBox
       SinaiBox (void);
       void TraceBox (SinaiRay &);
       void TraceToroid (SinaiRay &);
+      void TracePacketBox (RayPacket &);
+      void TracePacketToroid (RayPacket &);
+      void TraceMany (SinaiRay *, int n, int toroid);
    public:
 
       int niterations;
@@ -92,6 +142,7 @@ class SinaiBox
       double radius;
 
    private:
+      void TracePacket (RayPacket &, int toroid);
       Ray walls[6]; // left, right, top, bottom, front, back;
 };
 
@@ -17,6 +17,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "xfer.h"
 #include "zetafn.h"
 
 double
@@ -394,7 +395,7 @@ perron (double x, double *den, int cnt)
 }
 
 void
-iterate_perron (double *tgt, double *src, int cnt)
+iterate_perron_slow (double *tgt, double *src, int cnt)
 {
 	/* one iteration of frobenius-perron, 'exactly', subject to numerics */
 	int i;
@@ -405,6 +406,23 @@ iterate_perron (double *tgt, double *src, int cnt)
 	}
 }
 
+void
+iterate_perron (double *tgt, double *src, int cnt)
+{
+	/* Same as above, but with the branch sums worked out once, 
+	 * instead of on every iteration; see xfer.h. The branches that
+	 * perron() drops off the end are summed too. */
+	static xfer_op *op = NULL;
+	if (op && xfer_size(op) != cnt)
+	{
+		xfer_free (op);
+		op = NULL;
+	}
+	if (NULL == op) op = xfer_new (XFER_GAUSS, 0.0, XFER_UNIFORM, cnt);
+
+	xfer_apply (op, tgt, src);
+}
+
 void
 renorm_perron (double *tgt, double *src, int cnt)
 {
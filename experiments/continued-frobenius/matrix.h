@@ -3,6 +3,7 @@
  * matrix.h
  *
  * Matrix utils
+ * For matrices sized at run time, see mtx.h instead.
  *
  * Linas Jan 2004
  */
@@ -9,7 +9,7 @@
  *
  * Use LAPACK xGEEV routine
  * specifically, real double precision:
- * DGEEV
+ * DGEEV, by way of the mtx_d_geev() adapter in ../mtx-lapack.c
  *
  * Apply to find eigenvalues of the Gauss-Kuz'min-Wirsing (GKW) operator 
  *
@@ -21,51 +21,10 @@
 #include <stdlib.h>
 
 #include "ache.h"
+#include "mtx.h"
 #include "zetafn.h"
-#include "lapack.h"
 
 
-/* dry run -- get the working dimension */
-int 
-getworkdim (int dim, double *matrix,
-        double *eigenvalues_re, double *eigenvalues_im, 
-		  double *left_eigen, double *right_eigen,
-		  double *workspace)
-{
-
-	char jobvl = 'V';
-	char jobvr = 'V';
-	int workdim;
-	int info;
-
-	workdim = -1;
-
-	dgeev_ (&jobvl, &jobvr, &dim, matrix, &dim, 
-	       eigenvalues_re, eigenvalues_im, 
-			 left_eigen, &dim, right_eigen, &dim, 
-			 workspace, &workdim, &info);
-
-	return (int) (workspace[0]+0.5);
-}
-
-int 
-geteigen (int dim, double *matrix, 
-        double *eigenvalues_re, double *eigenvalues_im, 
-		  double *left_eigen, double *right_eigen,
-		  int workdim, double *workspace)
-{
-
-	char jobvl = 'V';
-	char jobvr = 'V';
-	int info;
-
-	dgeev_ (&jobvl, &jobvr, &dim, matrix, &dim, 
-	       eigenvalues_re, eigenvalues_im, 
-			 left_eigen, &dim, right_eigen, &dim, 
-			 workspace, &workdim, &info);
-
-}
-
 /* kinetic part only */
 double 
 kino (int m, int n)
@@ -142,14 +101,12 @@ void prtbin (double x)
 
 main (int argc, char * argv[]) 
 {
-	double *mat;
+	mtx_d *mat;
 	double *ere;
 	double *eim;
-	double *lev;
-	double *rev;
-	double *work;
+	mtx_d *lev;
+	mtx_d *rev;
 	int dim;
-	int workdim;
 	int i,j, k;
 	
 	dim = 28;
@@ -167,26 +124,23 @@ main (int argc, char * argv[])
 	printf ("# Numerically solved to rank=%d\n", dim);
 	printf ("#\n#\n");
 
-	mat = (double *) malloc (dim*dim*sizeof (double));
+	mat = mtx_d_new (dim, dim);
 	ere = (double *) malloc (dim*sizeof (double));
 	eim = (double *) malloc (dim*sizeof (double));
-	lev = (double *) malloc (dim*dim*sizeof (double));
-	rev = (double *) malloc (dim*dim*sizeof (double));
-	workdim = 4*dim*dim;
-	work = (double *) malloc (workdim*sizeof (double));
+	lev = mtx_d_new (dim, dim);
+	rev = mtx_d_new (dim, dim);
 
 	/* Insert values for the GKW operator at x=1 (y=1-x) */
 	for (i=0; i<dim; i++)
 	{
 		for (j=0; j<dim; j++)
 		{
-			/* Note transposed matrix'ing for FORTRAN */
-			// mat[i+j*dim] = ache_mp(i,j);
-			// mat[i+j*dim] = sst(i,j);
-			// mat[i+j*dim] = binomial(i,j) * exp (-(i+j)*0.2/dim);
-			// mat[i+j*dim] = mtm_svd(i,j);
-			mat[i+j*dim] = mmt_svd(i,j);
-			printf ("mat(%d, %d) = %g\n", i,j,mat[i+j*dim]);
+			// MTX(mat,i,j) = ache_mp(i,j);
+			// MTX(mat,i,j) = sst(i,j);
+			// MTX(mat,i,j) = binomial(i,j) * exp (-(i+j)*0.2/dim);
+			// MTX(mat,i,j) = mtm_svd(i,j);
+			MTX(mat,i,j) = mmt_svd(i,j);
+			printf ("mat(%d, %d) = %g\n", i,j,MTX(mat,i,j));
 		}
 		printf("\n");
 	}
@@ -197,18 +151,18 @@ main (int argc, char * argv[])
 	{
 		for (j=0; j<dim; j++)
 		{
-			/* Note transposed matrix'ing for FORTRAN */
-			mat[i+j*dim] -= kino(i,j);
+			MTX(mat,i,j) -= kino(i,j);
 		}
 	}
 #endif
 	
-	int wd = getworkdim (dim, mat, ere, eim, lev, rev, work);
-	printf ("# recommended dim=%d actual dim=%d\n#\n", wd, workdim);
-	// workdim = wd;
-	
-	work = (double *) realloc (work, workdim*sizeof (double));
-	geteigen (dim, mat, ere, eim, lev, rev, workdim, work);
+	/* The i'th eigenvectors are in the i'th columns of lev, rev */
+	int info = mtx_d_geev (mat, ere, eim, lev, rev);
+	if (info)
+	{
+		fprintf (stderr, "DGEEV failed, info=%d\n", info);
+		exit (1);
+	}
 
 	/* ---------------------------------------------- */
 	/* print the eigenvalues */
@@ -228,44 +182,44 @@ main (int argc, char * argv[])
 		for (j=0; j<prtdim; j++)
 		{
 			// printf ("# right %d'th eigenvector[%d]=%g (normalized=%g)\n", 
-			//            i,j, rev[j+i*dim], rev[j+i*dim]/rev[i*dim]);
+			//            i,j, MTX(rev,j,i), MTX(rev,j,i)/MTX(rev,0,i));
 			// printf ("# right %d'th eigenvector[%d]=%g (term ratio=%g)\n", 
-			//            i,j, rev[j+i*dim], rev[j+i*dim]/rev[j+1+i*dim]-2.0);
+			//            i,j, MTX(rev,j,i), MTX(rev,j,i)/MTX(rev,j+1,i)-2.0);
 			// printf ("# right %d'th eigenvector[%d]=%g (vec ratio=%g)\n", 
-			//            i,j, rev[j+i*dim],  tn*rev[j+i*dim] );
+			//            i,j, MTX(rev,j,i),  tn*MTX(rev,j,i) );
 			//
-			// double r1 = 2.0 * rev[j+1+i*dim]/rev[j+i*dim] - 1.0;
-			// double r2 = 2.0 * rev[j+2+i*dim]/rev[j+1+i*dim] - 1.0;
+			// double r1 = 2.0 * MTX(rev,j+1,i)/MTX(rev,j,i) - 1.0;
+			// double r2 = 2.0 * MTX(rev,j+2,i)/MTX(rev,j+1,i) - 1.0;
 			// double r = r1/r2;
 			// r *= j*j*j*j*log(log (log (log (j+1))));
 			// r *= j;
 #if RECURRSION_RELATION
-			double r = rev[j+1+i*dim]- 0.5*rev[j+i*dim];
-			r /= rev[j-1+i*dim];
+			double r = MTX(rev,j+1,i)- 0.5*MTX(rev,j,i);
+			r /= MTX(rev,j-1,i);
 			// r *= j*j*j* log(j+1) * log(j+1) * log(j+1);
 			r = log (r);
 			r /= j;
 			printf ("# right %d'th eigenvector[%d]=%g (term log ratio=%g)\n", 
-			           i,j, rev[j+i*dim], r);
+			           i,j, MTX(rev,j,i), r);
 #endif
 #if WHO_KNOWS_WHAT
-			double r = rev[j+i*dim] / (rev[30+i*dim] * (1<<30));
+			double r = MTX(rev,j,i) / (MTX(rev,30,i) * (1<<30));
 			r *= tn;
 			r -= 1.0;
 			r *= thrn;
 			printf ("# right %d'th eigenvector[%d]=%g (guh %g\n", 
-			            i,j, rev[j+i*dim], r);
+			            i,j, MTX(rev,j,i), r);
 #endif
 #if BINARY
 			printf ("# right %d'th eigenvector[%d]=%g (binary ", 
-			            i,j, rev[j+i*dim]);
-			r = rev[j+i*dim] / (rev[25+i*dim] * (1<<25));
+			            i,j, MTX(rev,j,i));
+			r = MTX(rev,j,i) / (MTX(rev,25,i) * (1<<25));
 			r *= tn;
 			prtbin (r);
 			printf (" )\n");
 #endif 
 			printf ("# right %d'th eigenvector[%d]=%g \n", 
-			            i,j, rev[j+i*dim]);
+			            i,j, MTX(rev,j,i));
 			            
 			tn *= 2.0;
 			thrn *= sqrt (3.0);
@@ -278,9 +232,15 @@ main (int argc, char * argv[])
 		for (j=0; j<prtdim; j++)
 		{
 			// printf ("# left %d'th eigenvector[%d]=%g (normalized=%g)\n", 
-			//            i,j, lev[j+i*dim], lev[j+i*dim]/lev[i*dim]);
-			printf ("# left %d'th eigenvector[%d]=%g (ratio=%g)\n", 
-			            i,j, lev[j+i*dim], ((j+1)*lev[j+i*dim])/((j+2)*lev[j+1+i*dim]));
+			//            i,j, MTX(lev,j,i), MTX(lev,j,i)/MTX(lev,0,i));
+			/* The last component has nothing after it to divide by */
+			if (j+1 == dim)
+			{
+				printf ("# left %d'th eigenvector[%d]=%g\n", i,j, MTX(lev,j,i));
+				continue;
+			}
+			printf ("# left %d'th eigenvector[%d]=%g (ratio=%g)\n",
+			            i,j, MTX(lev,j,i), ((j+1)*MTX(lev,j,i))/((j+2)*MTX(lev,j+1,i)));
 		}
 		printf ("#\n");
 	}
@@ -297,11 +257,11 @@ main (int argc, char * argv[])
 			double sum = 0.0;
 			for (k=0; k<dim; k++)
 			{
-				// sum += ache_mp(j,k) * rev[k+i*dim];
-				// sum += mtm_svd(j,k) * rev[k+i*dim];
-				sum += mmt_svd(j,k) * rev[k+i*dim];
+				// sum += ache_mp(j,k) * MTX(rev,k,i);
+				// sum += mtm_svd(j,k) * MTX(rev,k,i);
+				sum += mmt_svd(j,k) * MTX(rev,k,i);
 			}
-			sum /= rev[j+i*dim];
+			sum /= MTX(rev,j,i);
 			sum /= ere[i];
 			sum -= 1.0;
 			if (1.0e-12 < fabs(sum))
@@ -335,15 +295,15 @@ main (int argc, char * argv[])
 			/* The j'th element of the i'th eigenvector */
 			for (j=0; j<prtdim; j++)
 			{
-				norm += rev[j+i*dim];
+				norm += MTX(rev,j,i);
 			}
 			for (j=0; j<prtdim; j++)
 			{
 				// Factorial not needed, ache already has the factorial folded in.
 				// See, for example, the derives of seroth eigenvec. 
-				// sum += yn * rev[j+i*dim] / fact;
-				// sum += yn * rev[j+i*dim];
-				sum += yn * rev[j+i*dim] / norm;
+				// sum += yn * MTX(rev,j,i) / fact;
+				// sum += yn * MTX(rev,j,i);
+				sum += yn * MTX(rev,j,i) / norm;
 				// printf ("duuude j=%d fact=%g yn=%g\n", j, fact, yn);
 				yn *= y;
 				fact *= j+1;
@@ -367,10 +327,10 @@ exit(0);
 		/* The j'th element of the i'th eigenvector */
 		for (j=0; j<prtdim; j++)
 		{
-			norm[i] += rev[j+i*dim];
+			norm[i] += MTX(rev,j,i);
 		}
-		// norm[i] = 31.0 * lev[30+i*dim];
-		// norm[i] = (1<<25) *rev[25+i*dim];
+		// norm[i] = 31.0 * MTX(lev,30,i);
+		// norm[i] = (1<<25) *MTX(rev,25,i);
 	}
 
 	for (j=0; j<prtdim; j++)
@@ -378,8 +338,8 @@ exit(0);
 		printf ("%d\t", j);
 		for (i=0; i<13; i++)
 		{
-			printf ("%g\t", rev[j+i*dim]/norm[i]);
-			// printf ("%g\t", lev[j+i*dim]/norm[i]);
+			printf ("%g\t", MTX(rev,j,i)/norm[i]);
+			// printf ("%g\t", MTX(lev,j,i)/norm[i]);
 		}
 		printf ("\n");
 	}
@@ -0,0 +1,158 @@
+/*
+ * mtx-lapack.c
+ *
+ * Hand mtx_d matrices to the LAPACK routines used elsewhere in these
+ * experiments. LAPACK wants its matrices by columns, and mtx.h stores
+ * them by rows, so each adapter transposes into a scratch copy first,
+ * and the eigenvectors back out again. That is O(N^2), next to the
+ * O(N^3) of the eigenvalue problem.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <stdlib.h>
+
+#include "mtx.h"
+
+extern void dgeev_ (char *jobvl, char *jobvr, int *n, double *a, int *lda,
+                    double *wr, double *wi, double *vl, int *ldvl,
+                    double *vr, int *ldvr, double *work, int *lwork,
+                    int *info);
+
+extern void dhseqr_ (char *job, char *compz, int *n, int *ilo, int *ihi,
+                     double *h, int *ldh, double *wr, double *wi,
+                     double *z, int *ldz, double *work, int *lwork,
+                     int *info);
+
+extern void dstegr_ (char *jobz, char *range, int *n, double *d, double *e,
+                     double *vl, double *vu, int *il, int *iu,
+                     double *abstol, int *m, double *w, double *z, int *ldz,
+                     int *isuppz, double *work, int *lwork, int *iwork,
+                     int *liwork, int *info);
+
+/* A copy of m, by columns. */
+static double * to_columns (const mtx_d *m)
+{
+	int n = m->rows;
+	double *a = malloc ((size_t) n * n * sizeof(double) + 1);
+	int i, j;
+	for (i=0; i<n; i++)
+		for (j=0; j<n; j++)
+			a[j*n + i] = MTX(m,i,j);
+	return a;
+}
+
+static void from_columns (mtx_d *m, const double *a)
+{
+	int n = m->rows;
+	int i, j;
+	for (i=0; i<n; i++)
+		for (j=0; j<n; j++)
+			MTX(m,i,j) = a[j*n + i];
+}
+
+/* ==================================================================== */
+
+int mtx_d_geev (const mtx_d *m, double *wr, double *wi,
+                mtx_d *vl, mtx_d *vr)
+{
+	int n = m->rows;
+	char jobvl = vl ? 'V' : 'N';
+	char jobvr = vr ? 'V' : 'N';
+	double *a = to_columns (m);
+	double *l = vl ? malloc ((size_t) n * n * sizeof(double)) : NULL;
+	double *r = vr ? malloc ((size_t) n * n * sizeof(double)) : NULL;
+	int info;
+
+	/* Ask how much workspace it wants. */
+	double wsize;
+	int lwork = -1;
+	dgeev_ (&jobvl, &jobvr, &n, a, &n, wr, wi, l, &n, r, &n,
+	        &wsize, &lwork, &info);
+	lwork = (int) (wsize + 0.5);
+	if (lwork < 4*n) lwork = 4*n;
+	double *work = malloc (lwork * sizeof(double));
+
+	dgeev_ (&jobvl, &jobvr, &n, a, &n, wr, wi, l, &n, r, &n,
+	        work, &lwork, &info);
+
+	if (vl) from_columns (vl, l);
+	if (vr) from_columns (vr, r);
+	free (work);
+	free (l);
+	free (r);
+	free (a);
+	return info;
+}
+
+int mtx_d_hseqr (const mtx_d *h, double *wr, double *wi)
+{
+	int n = h->rows;
+	char job = 'E';
+	char compz = 'N';
+	int ilo = 1;
+	int ihi = n;
+	int ldz = 1;
+	double z;
+	double *a = to_columns (h);
+	int info;
+
+	double wsize;
+	int lwork = -1;
+	dhseqr_ (&job, &compz, &n, &ilo, &ihi, a, &n, wr, wi, &z, &ldz,
+	         &wsize, &lwork, &info);
+	lwork = (int) (wsize + 0.5);
+	if (lwork < n) lwork = n;
+	double *work = malloc (lwork * sizeof(double));
+
+	dhseqr_ (&job, &compz, &n, &ilo, &ihi, a, &n, wr, wi, &z, &ldz,
+	         work, &lwork, &info);
+
+	free (work);
+	free (a);
+	return info;
+}
+
+int mtx_d_stegr (const mtx_d *m, double *w, mtx_d *z)
+{
+	int n = m->rows;
+	char jobz = z ? 'V' : 'N';
+	char range = 'A';
+	double vl = 0.0, vu = 0.0;
+	int il = 0, iu = 0;
+	double abstol = 0.0;
+	int nfound;
+	int info;
+
+	double *d = malloc (n * sizeof(double));
+	double *e = malloc (n * sizeof(double));
+	int i;
+	for (i=0; i<n; i++)
+	{
+		d[i] = MTX(m,i,i);
+		e[i] = (i+1 < n) ? MTX(m,i+1,i) : 0.0;
+	}
+
+	double *zc = z ? malloc ((size_t) n * n * sizeof(double)) : NULL;
+	int ldz = n;
+	int *isuppz = malloc (2 * n * sizeof(int));
+	int lwork = 18*n;
+	int liwork = 10*n;
+	double *work = malloc (lwork * sizeof(double));
+	int *iwork = malloc (liwork * sizeof(int));
+
+	dstegr_ (&jobz, &range, &n, d, e, &vl, &vu, &il, &iu, &abstol,
+	         &nfound, w, zc, &ldz, isuppz, work, &lwork, iwork, &liwork,
+	         &info);
+
+	if (z) from_columns (z, zc);
+	free (iwork);
+	free (work);
+	free (isuppz);
+	free (zc);
+	free (e);
+	free (d);
+	return info;
+}
+
+/* ========================== END OF FILE ============= */
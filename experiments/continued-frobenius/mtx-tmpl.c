@@ -0,0 +1,202 @@
+/*
+ * mtx-tmpl.c
+ *
+ * The body of mtx.c, for one element type. Not compiled on its own;
+ * mtx.c includes it once for each type, with MTX_SFX and MTX_ELT set.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#define MTX_CAT2(a,b) a##b
+#define MTX_CAT(a,b) MTX_CAT2(a,b)
+#define MTX_TYPE MTX_CAT(mtx_, MTX_SFX)
+#define MTX_FN(name) MTX_CAT(MTX_CAT(MTX_TYPE, _), name)
+
+MTX_TYPE * MTX_FN(new) (int rows, int cols)
+{
+	MTX_TYPE *m = malloc (sizeof(MTX_TYPE));
+	m->rows = rows;
+	m->cols = cols;
+	m->ld = cols;
+	m->a = calloc ((size_t) rows * cols + 1, sizeof(MTX_ELT));
+	return m;
+}
+
+void MTX_FN(free) (MTX_TYPE *m)
+{
+	if (NULL == m) return;
+	free (m->a);
+	free (m);
+}
+
+MTX_TYPE MTX_FN(view) (const MTX_TYPE *m, int rows, int cols)
+{
+	MTX_TYPE v = *m;
+	if (rows < v.rows) v.rows = rows;
+	if (cols < v.cols) v.cols = cols;
+	return v;
+}
+
+void MTX_FN(ident) (MTX_TYPE *m, MTX_ELT val)
+{
+	int i, j;
+	for (i=0; i<m->rows; i++)
+	{
+		for (j=0; j<m->cols; j++)
+			MTX(m,i,j) = 0;
+		if (i < m->cols) MTX(m,i,i) = val;
+	}
+}
+
+void MTX_FN(copy) (MTX_TYPE *to, const MTX_TYPE *from)
+{
+	int i;
+	if (to->a == from->a && to->ld == from->ld) return;
+	for (i=0; i<from->rows; i++)
+		memmove (&MTX(to,i,0), &MTX(from,i,0), from->cols * sizeof(MTX_ELT));
+}
+
+void MTX_FN(transpose) (MTX_TYPE *to, const MTX_TYPE *from)
+{
+	int i, j;
+	if (to->a == from->a)
+	{
+		/* In place; must be square. */
+		for (i=0; i<from->rows; i++)
+			for (j=i+1; j<from->cols; j++)
+			{
+				MTX_ELT t = MTX(to,i,j);
+				MTX(to,i,j) = MTX(to,j,i);
+				MTX(to,j,i) = t;
+			}
+		return;
+	}
+
+	/* In blocks, so that neither side walks down a column for long. */
+	int i0, j0;
+	for (i0=0; i0<from->rows; i0+=MTX_BLOCK)
+		for (j0=0; j0<from->cols; j0+=MTX_BLOCK)
+			for (i=i0; i<from->rows && i<i0+MTX_BLOCK; i++)
+				for (j=j0; j<from->cols && j<j0+MTX_BLOCK; j++)
+					MTX(to,j,i) = MTX(from,i,j);
+}
+
+void MTX_FN(add) (MTX_TYPE *to, const MTX_TYPE *a, const MTX_TYPE *b)
+{
+	int i, j;
+	for (i=0; i<a->rows; i++)
+		for (j=0; j<a->cols; j++)
+			MTX(to,i,j) = MTX(a,i,j) + MTX(b,i,j);
+}
+
+void MTX_FN(scale) (MTX_TYPE *m, MTX_ELT scale)
+{
+	int i, j;
+	for (i=0; i<m->rows; i++)
+		for (j=0; j<m->cols; j++)
+			MTX(m,i,j) *= scale;
+}
+
+void MTX_FN(shift) (MTX_TYPE *m, MTX_ELT lambda)
+{
+	int i;
+	for (i=0; i<m->rows && i<m->cols; i++)
+		MTX(m,i,i) -= lambda;
+}
+
+/* prod += ml * mr, for the rows i0 <= i < i1 of prod. */
+static void MTX_FN(mult_rows) (MTX_TYPE *prod, const MTX_TYPE *ml,
+                               const MTX_TYPE *mr, int i0, int i1)
+{
+	int n = mr->cols;
+	int p = ml->cols;
+	int i, j, k, k0, j0;
+
+	/* The block of mr, MTX_BLOCK rows by MTX_JBLOCK columns, stays
+	 * in cache while it is used for each of the rows. */
+	for (k0=0; k0<p; k0+=MTX_BLOCK)
+	{
+		int k1 = (p < k0+MTX_BLOCK) ? p : k0+MTX_BLOCK;
+		for (j0=0; j0<n; j0+=MTX_JBLOCK)
+		{
+			int j1 = (n < j0+MTX_JBLOCK) ? n : j0+MTX_JBLOCK;
+			for (i=i0; i<i1; i++)
+			{
+				MTX_ELT *c = &MTX(prod,i,0);
+				for (k=k0; k<k1; k++)
+				{
+					MTX_ELT aik = MTX(ml,i,k);
+					const MTX_ELT *b = &MTX(mr,k,0);
+#pragma omp simd
+					for (j=j0; j<j1; j++)
+						c[j] += aik * b[j];
+				}
+			}
+		}
+	}
+}
+
+void MTX_FN(mult) (MTX_TYPE *prod, const MTX_TYPE *ml, const MTX_TYPE *mr)
+{
+	/* Multiplying in place goes through a scratch matrix. */
+	if (prod->a == ml->a || prod->a == mr->a)
+	{
+		MTX_TYPE *tmp = MTX_FN(new) (ml->rows, mr->cols);
+		MTX_FN(mult) (tmp, ml, mr);
+		MTX_FN(copy) (prod, tmp);
+		MTX_FN(free) (tmp);
+		return;
+	}
+
+	int i;
+	for (i=0; i<ml->rows; i++)
+		memset (&MTX(prod,i,0), 0, mr->cols * sizeof(MTX_ELT));
+
+	double work = ((double) ml->rows) * ml->cols * mr->cols;
+	int nblk = (ml->rows + MTX_BLOCK - 1) / MTX_BLOCK;
+	int ib;
+#pragma omp parallel for schedule(dynamic) if (MTX_PARALLEL_MIN < work)
+	for (ib=0; ib<nblk; ib++)
+	{
+		int i0 = ib * MTX_BLOCK;
+		int i1 = (ml->rows < i0+MTX_BLOCK) ? ml->rows : i0+MTX_BLOCK;
+		MTX_FN(mult_rows) (prod, ml, mr, i0, i1);
+	}
+}
+
+void MTX_FN(apply) (MTX_ELT *out, const MTX_TYPE *m, const MTX_ELT *in)
+{
+	int i;
+	double work = ((double) m->rows) * m->cols;
+#pragma omp parallel for schedule(static) if (MTX_PARALLEL_MIN < work)
+	for (i=0; i<m->rows; i++)
+	{
+		const MTX_ELT *row = &MTX(m,i,0);
+		MTX_ELT acc = 0;
+		int j;
+		for (j=0; j<m->cols; j++)
+			acc += row[j] * in[j];
+		out[i] = acc;
+	}
+}
+
+void MTX_FN(to_d) (mtx_d *to, const MTX_TYPE *from)
+{
+	int i, j;
+	for (i=0; i<from->rows; i++)
+		for (j=0; j<from->cols; j++)
+			MTX(to,i,j) = (double) MTX(from,i,j);
+}
+
+void MTX_FN(from_d) (MTX_TYPE *to, const mtx_d *from)
+{
+	int i, j;
+	for (i=0; i<from->rows; i++)
+		for (j=0; j<from->cols; j++)
+			MTX(to,i,j) = (MTX_ELT) MTX(from,i,j);
+}
+
+#undef MTX_CAT2
+#undef MTX_CAT
+#undef MTX_TYPE
+#undef MTX_FN
@@ -0,0 +1,44 @@
+/*
+ * mtx.c
+ *
+ * Dense matrices, sized at run time; see mtx.h.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mtx.h"
+
+/* Block sizes for the multiply: MTX_BLOCK rows of the product at a
+ * time, against MTX_BLOCK x MTX_JBLOCK pieces of the right factor.
+ * The piece is 128KB in double, and twice that in long double. */
+#define MTX_BLOCK 64
+#define MTX_JBLOCK 256
+
+/* Number of multiply-adds below which it's not worth starting
+ * threads. */
+#define MTX_PARALLEL_MIN 1.0e6
+
+#define MTX_SFX d
+#define MTX_ELT double
+#include "mtx-tmpl.c"
+#undef MTX_SFX
+#undef MTX_ELT
+
+#define MTX_SFX ld
+#define MTX_ELT long double
+#include "mtx-tmpl.c"
+#undef MTX_SFX
+#undef MTX_ELT
+
+#ifdef MTX_HAVE_FLOAT128
+#define MTX_SFX q
+#define MTX_ELT __float128
+#include "mtx-tmpl.c"
+#undef MTX_SFX
+#undef MTX_ELT
+#endif
+
+/* ========================== END OF FILE ============= */
@@ -0,0 +1,134 @@
+/*
+ * mtx.h
+ *
+ * Dense matrices, sized at run time.
+ *
+ * The successor to matrix.h, whose matrix type is an MS x MS array,
+ * fixed at compile time, multiplied with a plain triple loop. That
+ * means recompiling for every truncation size, and, past a few hundred
+ * rows, waiting on a multiply that misses the cache on every step
+ * through the right-hand matrix.
+ *
+ * There are three element types, each with its own set of functions:
+ *    mtx_d   double         mtx_d_new(), mtx_d_mult(), ...
+ *    mtx_ld  long double    mtx_ld_new(), mtx_ld_mult(), ...
+ *    mtx_q   __float128     mtx_q_new(), mtx_q_mult(), ...
+ * The last only where the compiler has __float128. The functions are
+ * the same for each type; below, T is the element type and mtx_T
+ * the matrix type:
+ *
+ * mtx_T * mtx_T_new (int rows, int cols)
+ *    A new matrix, filled with zeros.
+ * void mtx_T_free (mtx_T *m)
+ * mtx_T mtx_T_view (const mtx_T *m, int rows, int cols)
+ *    The leading rows x cols submatrix of m, sharing its storage;
+ *    for working with truncations of one big matrix. Views are not
+ *    freed.
+ * void mtx_T_ident (mtx_T *m, T val)          m = val * I
+ * void mtx_T_copy (mtx_T *to, const mtx_T *from)
+ * void mtx_T_transpose (mtx_T *to, const mtx_T *from)
+ * void mtx_T_add (mtx_T *to, const mtx_T *a, const mtx_T *b)
+ * void mtx_T_scale (mtx_T *m, T scale)
+ * void mtx_T_shift (mtx_T *m, T lambda)       m = m - lambda * I
+ * void mtx_T_mult (mtx_T *prod, const mtx_T *ml, const mtx_T *mr)
+ *    prod = ml * mr. The product may be one of the factors.
+ * void mtx_T_apply (T *out, const mtx_T *m, const T *in)
+ *    out = m * in, for vectors; out and in must not overlap.
+ * void mtx_T_to_d (mtx_d *to, const mtx_T *from)
+ * void mtx_T_from_d (mtx_T *to, const mtx_d *from)
+ *    Convert to and from double, e.g. to hand to LAPACK.
+ *
+ * The matrix multiply is done in blocks that fit in cache, and, if
+ * compiled with -fopenmp, the rows of blocks are spread over all of
+ * the cores; OMP_NUM_THREADS sets the number of threads.
+ *
+ * Elements are stored by rows: m->a[i*m->ld + j] is row i, column j,
+ * which MTX(m,i,j) spells out. The double version can be handed to
+ * LAPACK with the adapters in mtx-lapack.c, declared at the end.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __MTX_H__
+#define __MTX_H__
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define MTX(m,i,j) ((m)->a[(i)*(m)->ld + (j)])
+
+#define MTX_DECLARE(SFX, T)                                              \
+typedef struct                                                           \
+{                                                                        \
+	int rows;                                                             \
+	int cols;                                                             \
+	int ld;            /* distance from one row to the next */           \
+	T *a;                                                                 \
+} mtx_##SFX;                                                             \
+                                                                         \
+mtx_##SFX * mtx_##SFX##_new (int rows, int cols);                        \
+void mtx_##SFX##_free (mtx_##SFX *m);                                    \
+mtx_##SFX mtx_##SFX##_view (const mtx_##SFX *m, int rows, int cols);     \
+void mtx_##SFX##_ident (mtx_##SFX *m, T val);                            \
+void mtx_##SFX##_copy (mtx_##SFX *to, const mtx_##SFX *from);            \
+void mtx_##SFX##_transpose (mtx_##SFX *to, const mtx_##SFX *from);       \
+void mtx_##SFX##_add (mtx_##SFX *to, const mtx_##SFX *a,                 \
+                      const mtx_##SFX *b);                               \
+void mtx_##SFX##_scale (mtx_##SFX *m, T scale);                          \
+void mtx_##SFX##_shift (mtx_##SFX *m, T lambda);                         \
+void mtx_##SFX##_mult (mtx_##SFX *prod, const mtx_##SFX *ml,             \
+                       const mtx_##SFX *mr);                             \
+void mtx_##SFX##_apply (T *out, const mtx_##SFX *m, const T *in);
+
+MTX_DECLARE(d, double)
+MTX_DECLARE(ld, long double)
+#ifdef __SIZEOF_FLOAT128__
+#define MTX_HAVE_FLOAT128 1
+MTX_DECLARE(q, __float128)
+#endif
+
+/* The conversions need mtx_d, so they come after. */
+#define MTX_DECLARE_CONVERT(SFX)                                         \
+void mtx_##SFX##_to_d (mtx_d *to, const mtx_##SFX *from);                \
+void mtx_##SFX##_from_d (mtx_##SFX *to, const mtx_d *from);
+
+MTX_DECLARE_CONVERT(d)
+MTX_DECLARE_CONVERT(ld)
+#ifdef MTX_HAVE_FLOAT128
+MTX_DECLARE_CONVERT(q)
+#endif
+
+/* ----------------------------------------------------------------- */
+/* LAPACK adapters, in mtx-lapack.c; link with -llapack. Each returns
+ * the LAPACK info code: zero on success. The matrix passed in is left
+ * alone. */
+
+/**
+ * mtx_d_geev -- eigenvalues wr + i*wi of a general square matrix,
+ * as DGEEV (see matrix/eigen.c). If vl or vr is not NULL, the left
+ * or right eigenvectors are returned in its columns, packed the way
+ * DGEEV packs them.
+ */
+int mtx_d_geev (const mtx_d *m, double *wr, double *wi,
+                mtx_d *vl, mtx_d *vr);
+
+/**
+ * mtx_d_hseqr -- eigenvalues wr + i*wi of an upper Hessenberg
+ * matrix, as DHSEQR (see beta-xform/psiblas.c).
+ */
+int mtx_d_hseqr (const mtx_d *h, double *wr, double *wi);
+
+/**
+ * mtx_d_stegr -- eigenvalues w, in increasing order, of a symmetric
+ * tridiagonal matrix, as DSTEGR (see schroedinger/diffy.c). Only the
+ * diagonal and subdiagonal of m are looked at. If z is not NULL, the
+ * eigenvectors are returned in its columns.
+ */
+int mtx_d_stegr (const mtx_d *m, double *w, mtx_d *z);
+
+#ifdef  __cplusplus
+};
+#endif
+
+#endif /* __MTX_H__ */
@@ -16,58 +16,60 @@
 
 // =================================================================
 
-#define MS 10 // matrix dimension
-#include "matrix.h"
+#include "mtx.h"
 
 // =================================================================
 
-matrix  *gfp; // gkw 
-matrix  *transp; // gkw 
-matrix  *pa, *pb, *norm; // gkw 
+mtx_ld  *gfp; // gkw 
+mtx_ld  *transp; // gkw 
+mtx_ld  *pa, *pb, *norm; // gkw 
 
-void initialize (void)
+void initialize (int dim)
 {
 	int i,j;
 	
-	printf ("sizeof matrix = %d\n", sizeof (matrix));
+	printf ("matrix dim = %d\n", dim);
 
-	gfp = (matrix *) malloc (sizeof (matrix));
-	transp = (matrix *) malloc (sizeof (matrix));
-	pa = (matrix *) malloc (sizeof (matrix));
-	pb = (matrix *) malloc (sizeof (matrix));
-	norm = (matrix *) malloc (sizeof (matrix));
+	gfp = mtx_ld_new (dim, dim);
+	transp = mtx_ld_new (dim, dim);
+	pa = mtx_ld_new (dim, dim);
+	pb = mtx_ld_new (dim, dim);
+	norm = mtx_ld_new (dim, dim);
 	
 	// initialize the frobenius-perron operator
-	for (i=0; i<MS; i++)
+	for (i=0; i<dim; i++)
 	{
-		for (j=0; j<MS; j++)
+		for (j=0; j<dim; j++)
 		{
-			(*gfp)[i][j] = ache_mp(i,j);
-			(*transp)[i][j] = (*gfp)[j][i];
-if (i<5 && j<5) printf("M[%d][%d] = %Lf\n", i, j, (*gfp)[i][j]);
+			MTX(gfp,i,j) = ache_mp(i,j);
+if (i<5 && j<5) printf("M[%d][%d] = %Lf\n", i, j, MTX(gfp,i,j));
 		}
 	}
+	mtx_ld_transpose (transp, gfp);
 	printf ("done init\n");
 }
 
 // =================================================================
 
 int
-main ()
+main (int argc, char * argv[])
 {
 	int i,j;
+	int dim = 10;
 
-	initialize();
-	multmatrix (pa, gfp, transp);
-	multmatrix (pb, transp, gfp);
-	scalematrix(pb, -1.0);
-	addmatrix (norm, pa, pb);
+	if (2 <= argc) dim = atoi (argv[1]);
 
-	for (i=0; i<MS; i++)
+	initialize(dim);
+	mtx_ld_mult (pa, gfp, transp);
+	mtx_ld_mult (pb, transp, gfp);
+	mtx_ld_scale(pb, -1.0L);
+	mtx_ld_add (norm, pa, pb);
+
+	for (i=0; i<dim; i++)
 	{
-		for (j=0; j<MS; j++)
+		for (j=0; j<dim; j++)
 		{
-if (i<5 && j<5) printf("norm[%d][%d] = %Lf\n", i, j, (*norm)[i][j]);
+if (i<5 && j<5) printf("norm[%d][%d] = %Lf\n", i, j, MTX(norm,i,j));
 		}
 	}
 	return 0;
@@ -9,6 +9,7 @@
  * range = 0 to 10, NLIN = 3, no prods
  * range = -9 to 9, NLIN = 2, 2x prods
  * 
+ * Usage: tryall [<vector length>]; the default length is 30.
  *
  * Linas Dec 2003
  */
@@ -18,43 +19,45 @@
 #include <stdlib.h>
 
 #include "ache.h"
+#include "mtx.h"
 #include "zetafn.h"
 
 
-#define MS 30 // vector length
+int ms = 30; // vector length
 
+// The matrix is an mtx_d, so dubya has to be double.
 typedef double dubya;
-// typedef long double dubya;
 
-typedef dubya vector[MS];
-typedef dubya matrix[MS][MS];
+// A vector is ms dubyas. A list of vectors is one array, with the
+// i'th vector at [i*ms].
 
 // ============================================================
-// initialize a static copy of the H matrix
-matrix *
+// initialize a copy of the H matrix
+mtx_d *
 init_ache (void)
 {
-	matrix * mat = (matrix *) malloc (sizeof (matrix));
+	mtx_d * mat = mtx_d_new (ms, ms);
 
 	int m,p;
-	for (m=0; m<MS; m++)
+	for (m=0; m<ms; m++)
 	{
-		for (p=0; p<MS; p++)
+		for (p=0; p<ms; p++)
 		{
-			(*mat)[m][p] = ache_mp(m,p);
+			MTX(mat,m,p) = ache_mp(m,p);
 		}
 	}
 	return mat;
 }
 
-vector zeroth_eigenvec;
+dubya *zeroth_eigenvec;
 
 void
 init_zeroth (void)
 {
 	int k;
+	zeroth_eigenvec = (dubya *) malloc (ms * sizeof (dubya));
 	dubya acc = sqrtl(3.0L) / 2.0L;
-	for (k=0; k<MS; k++)
+	for (k=0; k<ms; k++)
 	{
 		zeroth_eigenvec[k] = acc;
 		acc *= 0.5;
@@ -171,20 +174,20 @@ int do_combo[NBASIS];
 	printf ("\nInitial basis vector %d: %s:\n", ib, #expr);  \
 	int k; \
 	dubya sign = 1.0L;  \
-	for (k=0; k<MS; k++)  \
+	for (k=0; k<ms; k++)  \
 	{  \
-		basis[ib][k] = expr; \
-		printf ("%d %d %g\n", ib,k, basis[ib][k]);   \
+		basis[ib*ms + k] = expr; \
+		printf ("%d %d %g\n", ib,k, basis[ib*ms + k]);   \
 		sign = - sign;  \
 	}  \
 	ib ++; \
 	if (NBASIS <= ib) { printf ("NOT ENOUGH!\n"); exit (1); } \
 }
 
-vector *
+dubya *
 init_basis_vectors (int *len)
 {
-	vector * basis = (vector *) malloc (NBASIS * sizeof (vector));
+	dubya * basis = (dubya *) malloc (NBASIS * ms * sizeof (dubya));
 
 	int ib = 0;
 	
@@ -328,30 +331,30 @@ init_basis_vectors (int *len)
 // ============================================================
 // create multiplicative combinations of basis vectors
 
-vector *
-init_double_prod (vector *basis, int baselen, int *retlen)
+dubya *
+init_double_prod (dubya *basis, int baselen, int *retlen)
 {
 	*retlen = baselen * (baselen+1);
 	*retlen /= 2;
-	vector * prod = (vector *) malloc ((*retlen) * sizeof (vector));
+	dubya * prod = (dubya *) malloc ((*retlen) * ms * sizeof (dubya));
 
 	printf ("double combo \n");
 	int jdx =0;
 	int i,j;
 	for (i=0; i<baselen; i++)
 	{
-		vector *ba = &basis[i];
+		dubya *ba = &basis[i*ms];
 		for (j=i; j<baselen; j++)
 		{
 			// we don't want to pair up certain pairs
 			if (0 == do_combo[i]+do_combo[j]) continue;
 
-			vector *bb = &basis[j];
-			vector *v = &prod[jdx];
+			dubya *bb = &basis[j*ms];
+			dubya *v = &prod[jdx*ms];
 			int k;
-			for (k=0; k<MS; k++)
+			for (k=0; k<ms; k++)
 			{
-				(*v)[k] = ((*ba)[k]) * ((*bb)[k]);
+				v[k] = ba[k] * bb[k];
 			}
 			printf ("product [%d] = [%d] * [%d]\n", jdx, i, j);
 			jdx ++;
@@ -362,30 +365,30 @@ init_double_prod (vector *basis, int baselen, int *retlen)
 	return prod;
 }
 
-vector *
-init_triple_prod (vector *basis, int baselen, int *retlen)
+dubya *
+init_triple_prod (dubya *basis, int baselen, int *retlen)
 {
 	*retlen = baselen * (baselen+1)*(baselen+2);
 	*retlen /= 6;
-	vector * prod = (vector *) malloc ((*retlen) * sizeof (vector));
+	dubya * prod = (dubya *) malloc ((*retlen) * ms * sizeof (dubya));
 
 	printf ("triple combo \n");
 	int jdx =0;
 	int i,j,m;
 	for (i=0; i<baselen; i++)
 	{
-		vector *ba = &basis[i];
+		dubya *ba = &basis[i*ms];
 		for (j=i; j<baselen; j++)
 		{
-			vector *bb = &basis[j];
+			dubya *bb = &basis[j*ms];
 			for (m=j; m<baselen; m++)
 			{
-				vector *bc = &basis[m];
-				vector *v = &prod[jdx];
+				dubya *bc = &basis[m*ms];
+				dubya *v = &prod[jdx*ms];
 				int k;
-				for (k=0; k<MS; k++)
+				for (k=0; k<ms; k++)
 				{
-					(*v)[k] = ((*ba)[k]) * ((*bb)[k]) * ((*bc)[k]);
+					v[k] = ba[k] * bb[k] * bc[k];
 				}
 				printf ("product [%d] = [%d] * [%d] * [%d]\n", jdx, i, j, m);
 				jdx ++;
@@ -405,23 +408,23 @@ init_triple_prod (vector *basis, int baselen, int *retlen)
 // make bais vectors orthogonal to zeroth eigenvector
 
 void
-orthogonalize (vector *basis, int baselen)
+orthogonalize (dubya *basis, int baselen)
 {
 	printf ("orthogonalizing the basis vectors !\n");
 	int ib;
 	for (ib=0; ib<baselen; ib++)
 	{
-		vector *w = &basis[ib];
+		dubya *w = &basis[ib*ms];
 		// orthogonalize to eigenvec
 		dubya dot = 0.0;
 		int n;
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
-			dot += zeroth_eigenvec[n] * (*w)[n];
+			dot += zeroth_eigenvec[n] * w[n];
 		}
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
-			(*w)[n] -= zeroth_eigenvec[n] * dot;
+			w[n] -= zeroth_eigenvec[n] * dot;
 		}
 	}
 }
@@ -445,7 +448,7 @@ static unsigned long long int nrediscover = 0;
 static unsigned long long int nclosecall = 0;
 static unsigned long long int ngood = 0;
 
-int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
+int evaluate (const mtx_d *H, const dubya *vec, dubya goodness, int nterms)
 {
 	nattempts ++;
 	if (0 == nattempts%4000100)
@@ -462,8 +465,8 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 		fflush (stdout);
 	}
 
-	int k = MS-1;
-	if ((1.0L < (*vec)[k]) || (-1.0L > (*vec)[k]))
+	int k = ms-1;
+	if ((1.0L < vec[k]) || (-1.0L > vec[k]))
 	{
 		ndive ++;
 		return 99;
@@ -471,30 +474,22 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 	
 #define JORDANIZE
 #ifdef JORDANIZE
-	vector w;
+	dubya w[ms];
 	int n;
-	for (n=0; n<MS; n++)
-	{
-		dubya acc = 0.0L;
-		for (k=0; k<MS; k++)
-		{
-			acc += (*H)[n][k] * (*vec)[k]; 
-		}
-		w[n] = acc;
-	}
+	mtx_d_apply (w, H, vec);
 
 	// now orthogonalize to eigenvec
 	dubya dot = 0.0;
-	for (n=0; n<MS; n++)
+	for (n=0; n<ms; n++)
 	{
 		dot += zeroth_eigenvec[n] * w[n];
 	}
-	for (n=0; n<MS; n++)
+	for (n=0; n<ms; n++)
 	{
 		w[n] -= zeroth_eigenvec[n] * dot;
 	}
 	
-	dubya w0 = w[0] / (*vec)[0];
+	dubya w0 = w[0] / vec[0];
 
 	// resume simple tests
 	if (isnan (w0))
@@ -512,11 +507,11 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 	}
 
 	// sample 'widely'
-	double step = ((double) MS-2) / ((double) nterms-2);
+	double step = ((double) ms-2) / ((double) nterms-2);
 	int nstep = (int) step;
 
 	// eigenvalue must be eigen-like
-	dubya w1 = w[1] /(*vec)[1];
+	dubya w1 = w[1] /vec[1];
 
 	dubya wd = w0-w1;
 #define SCALE_GOOD
@@ -532,9 +527,9 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 
 	// try higher up the eigenvector
 	int ntest = 3;
-	for (n=2; n<MS; n+= nstep) 
+	for (n=2; n<ms; n+= nstep) 
 	{
-		dubya wn = w[n]/ (*vec)[n];
+		dubya wn = w[n]/ vec[n];
 		dubya wd = w0-wn;
 		if ((goodness <= wd) || (-goodness >= wd))
 		{
@@ -570,36 +565,36 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 		// if we got to here, we have what smells like
 		// an eignevector!
 		dubya avg = 0.0L;
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
-			dubya term = w[n] / (*vec)[n];
+			dubya term = w[n] / vec[n];
 			avg += term;
 		}
-		avg /= ((dubya) MS);
+		avg /= ((dubya) ms);
 		
 		dubya dev = 0.0L;
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
-			dubya term = w[n] / (*vec)[n] - avg;
+			dubya term = w[n] / vec[n] - avg;
 			dev += term*term;
 		}
-		dev /= (dubya) MS;
+		dev /= (dubya) ms;
 		dev = sqrt(dev);
 		
 		printf ("===================================\n");
 		printf ("CANDidate eigen=%g    DEVIATION=%g\n", avg, dev);
 
 		printf ("candidate eigenvalue w[0]=%g   w[1]=%g   ", w0, w1);
-		for (n=2; n<MS; n += nstep) 
+		for (n=2; n<ms; n += nstep) 
 		{
-			double wn = w[n] / (*vec)[n];
+			double wn = w[n] / vec[n];
 			printf ("w[%d]=%g   ",n, (double)wn);
 		}
 		printf ("\n");
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
-			dubya eval = w[n] / (*vec)[n];
-			printf ("cand eigenvec v[%d]=%g Hv=%g eigval=%g diff=%g\n", n, (*vec)[n], w[n], eval, w0-eval); 
+			dubya eval = w[n] / vec[n];
+			printf ("cand eigenvec v[%d]=%g Hv=%g eigval=%g diff=%g\n", n, vec[n], w[n], eval, w0-eval); 
 		}
 		fflush (stdout);
 		ngood ++;
@@ -609,11 +604,11 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 
 #if PLAIN_EIGENVEC
 	dubya w0 = 0.0L;
-	for (k=0; k<MS; k++)
+	for (k=0; k<ms; k++)
 	{
-		w0 += (*H)[0][k] * (*vec)[k]; 
+		w0 += MTX(H,0,k) * vec[k]; 
 	}
-	w0 /= (*vec)[0];
+	w0 /= vec[0];
 
 	if (isnan (w0))
 	{
@@ -630,17 +625,17 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 	}
 
 	// sample 'widely'
-	double step = ((double) MS-2) / ((double) nterms-2);
+	double step = ((double) ms-2) / ((double) nterms-2);
 	int nstep = (int) step;
 
 	dubya w1 = 0.0L;
-	for (k=0; k<MS; k++)
+	for (k=0; k<ms; k++)
 	{
-		w1 += (*H)[1][k] * (*vec)[k]; 
+		w1 += MTX(H,1,k) * vec[k]; 
 	}
 	
 	// eigenvalue must be eigen-like
-	w1 /= (*vec)[1];
+	w1 /= vec[1];
 	dubya wd = w0-w1;
 #if SCALE_GOOD
 	goodness *= w0;
@@ -655,14 +650,14 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 	// try higher up the eigenvector
 	int n;
 	int ntest = 3;
-	for (n=2; n<MS; n+= nstep) 
+	for (n=2; n<ms; n+= nstep) 
 	{
 		dubya w = 0.0L;
-		for (k=0; k<MS; k++)
+		for (k=0; k<ms; k++)
 		{
-			w += (*H)[n][k] * (*vec)[k]; 
+			w += MTX(H,n,k) * vec[k]; 
 		}
-		w /= (*vec)[n];
+		w /= vec[n];
 		dubya wd = w0-w;
 		if ((goodness <= wd) || (-goodness >= wd))
 		{
@@ -698,26 +693,26 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 		// if we got to here, we have what smells like
 		// an eignevector!
 		printf ("plain candidate eigenvalue w[0]=%g   w[1]=%g   ", w0, w1);
-		for (n=2; n<MS; n += nstep) 
+		for (n=2; n<ms; n += nstep) 
 		{
 			dubya wn = 0.0L;
-			for (k=0; k<MS; k++)
+			for (k=0; k<ms; k++)
 			{
-				wn += (*H)[n][k] * (*vec)[k]; 
+				wn += MTX(H,n,k) * vec[k]; 
 			}
-			wn /= (*vec)[n];
+			wn /= vec[n];
 			printf ("w[%d]=%g   ",n, (double)wn);
 		}
 		printf ("\n");
-		for (n=0; n<MS; n++)
+		for (n=0; n<ms; n++)
 		{
 			dubya wn = 0.0L;
-			for (k=0; k<MS; k++)
+			for (k=0; k<ms; k++)
 			{
-				wn += (*H)[n][k] * (*vec)[k]; 
+				wn += MTX(H,n,k) * vec[k]; 
 			}
-			dubya eval = wn / (*vec)[n];
-			printf ("plain cand eigenvec v[%d]=%g Hv=%g eigval=%g diff=%g\n", n, (*vec)[n], wn, eval, w0-eval); 
+			dubya eval = wn / vec[n];
+			printf ("plain cand eigenvec v[%d]=%g Hv=%g eigval=%g diff=%g\n", n, vec[n], wn, eval, w0-eval); 
 		}
 		fflush (stdout);
 		ngood ++;
@@ -730,7 +725,8 @@ int evaluate (matrix *H, vector *vec, dubya goodness, int nterms)
 // ============================================================
 // try the various different combinatorial possibilities
 
-static vector *combo_basis = NULL;
+static dubya *combo_basis = NULL;
+static dubya *combo_vec = NULL;
 static int combo_basis_len = 0;
 
 #define NLIN 20
@@ -743,10 +739,11 @@ int idx[NLIN];
 #define MAXCOFF 9
 
 void 
-init_combo_basis (vector *basis, int nvec)
+init_combo_basis (dubya *basis, int nvec)
 {
 	combo_basis = basis;
 	combo_basis_len = nvec;
+	combo_vec = (dubya *) malloc (ms * sizeof (dubya));
 }
 
 int idx_end[NLIN];
@@ -776,10 +773,9 @@ init_combo (int nlow)
 }
 
 
-vector * 
+dubya * 
 next_combo (int nlin, int nlow)
 {
-	static vector combo_vec;
 	dubya frac[NLIN];
 	dubya sign[NLIN];
 
@@ -864,30 +860,30 @@ nextvec:
 	
 	// don't compute all the terms if the highest term is too big.
 	// this should save some cpu time.
-	int k = MS-1;
+	int k = ms-1;
 	combo_vec[k] = 0.0L;
 	for (i=0; i<nlin; i++)
 	{
 		dubya s = 1.0L;
 		if (k%2 == 1) s *= alt[i];
-		dubya term = s * frac[i] * combo_basis[idx[i]][k];
+		dubya term = s * frac[i] * combo_basis[idx[i]*ms + k];
 		combo_vec[k] += term;
 	}
 	if ((1.0L > combo_vec[k]) && (-1.0L < combo_vec[k]))
 	{ 
-		for (k=0; k<MS-1; k++)
+		for (k=0; k<ms-1; k++)
 		{
 			combo_vec[k] = 0.0L;
 			for (i=0; i<nlin; i++)
 			{
-				dubya term = sign[i] * frac[i] * combo_basis[idx[i]][k];
+				dubya term = sign[i] * frac[i] * combo_basis[idx[i]*ms + k];
 				combo_vec[k] += term;
 				sign[i] = alt[i] * sign[i];
 			}
 		}
 	}
 
-	return &combo_vec;
+	return combo_vec;
 }
 
 void
@@ -941,24 +937,24 @@ dump_combo_state (int nlin)
 void 
 run (void)
 {
-	matrix *h = init_ache ();
+	mtx_d *h = init_ache ();
 	init_zeroth ();
 
 	int nbasis = 0;
-	vector *basis = init_basis_vectors (&nbasis);
+	dubya *basis = init_basis_vectors (&nbasis);
 	
 #if 0
 	// tried these, didn't get anything 
 	int nc = nbasis;
-	vector *cv = basis;
+	dubya *cv = basis;
 #else
 	
 	int nprod = 0;
-	vector *prod = init_double_prod (basis, nbasis, &nprod);
-	// vector *prod = init_triple_prod (basis, nbasis, &nprod);
+	dubya *prod = init_double_prod (basis, nbasis, &nprod);
+	// dubya *prod = init_triple_prod (basis, nbasis, &nprod);
 	
 	int nc = nprod;
-	vector *cv = prod;
+	dubya *cv = prod;
 #endif
 	init_combo_basis (cv, nc);
 	orthogonalize (cv, nc);
@@ -972,7 +968,7 @@ run (void)
 	int nterms = 5;
 	dubya accuracy = 0.3L;
 	
-	vector *vec = next_combo(nlin, 0);
+	dubya *vec = next_combo(nlin, 0);
 	while (1)
 	{
 		int rc = evaluate (h, vec, accuracy, nterms);
@@ -1013,7 +1009,7 @@ done:
 						 nlin, nterms, accuracy);
 	
 	// set_combo_state (4,48,67,86);
-	vector *vec = next_combo(nlin, 0);
+	dubya *vec = next_combo(nlin, 0);
 	while (vec)
 	{
 		int rc = evaluate (h, vec, accuracy, nterms);
@@ -1032,6 +1028,12 @@ int
 main (int argc, char *argv[])
 {
 	double p;
+	if (1 < argc) ms = atoi (argv[1]);
+	if (ms < 3)
+	{
+		fprintf (stderr, "Usage: %s [<vector length>]\n", argv[0]);
+		exit (1);
+	}
 	run();
 
 	printf ("Number of Attempts = %lld\n", nattempts);
@@ -0,0 +1,113 @@
+/*
+ * xfer-power.c
+ *
+ * Power iteration with the transfer operators of xfer.h: find the
+ * invariant density, and then, after projecting it out, the first
+ * decaying eigenmode and its eigenvalue. For the Gauss map, that is
+ * the Gauss-Kuzmin-Wirsing constant, -0.3036630028987...
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "xfer.h"
+
+static double now (void)
+{
+	struct timeval tv;
+	gettimeofday (&tv, NULL);
+	return tv.tv_sec + 1.0e-6 * tv.tv_usec;
+}
+
+static double integrate (const xfer_op *op, const double *den)
+{
+	const double *w = xfer_weights (op);
+	double acc = 0.0;
+	int i;
+	for (i=0; i<xfer_size(op); i++) acc += w[i] * den[i];
+	return acc;
+}
+
+static double dot (const xfer_op *op, const double *a, const double *b)
+{
+	const double *w = xfer_weights (op);
+	double acc = 0.0;
+	int i;
+	for (i=0; i<xfer_size(op); i++) acc += w[i] * a[i] * b[i];
+	return acc;
+}
+
+int
+main (int argc, char * argv[])
+{
+	if (argc < 4)
+	{
+		fprintf (stderr, "Usage: %s <gauss|beta|tent> <K> <cnt> [cheb] [<niter>]\n", argv[0]);
+		fprintf (stderr, "K is ignored for the gauss map.\n");
+		exit (1);
+	}
+
+	xfer_map map = XFER_GAUSS;
+	if (!strcmp (argv[1], "beta")) map = XFER_BETA;
+	if (!strcmp (argv[1], "tent")) map = XFER_TENT;
+	double K = atof (argv[2]);
+	int cnt = atoi (argv[3]);
+
+	xfer_grid grid = XFER_UNIFORM;
+	int niter = 60;
+	int i, k;
+	for (i=4; i<argc; i++)
+	{
+		if (!strcmp (argv[i], "cheb")) grid = XFER_CHEBYSHEV;
+		else niter = atoi (argv[i]);
+	}
+
+	double start = now();
+	xfer_op *op = xfer_new (map, K, grid, cnt);
+	printf ("# setup: %g secs, %ld coefficients\n", now()-start, xfer_nnz(op));
+
+	const double *x = xfer_points (op);
+	double *rho = malloc (cnt * sizeof(double));
+	double *den = malloc (cnt * sizeof(double));
+	double *tmp = malloc (cnt * sizeof(double));
+
+	/* The invariant density, normalized to unit integral. */
+	for (i=0; i<cnt; i++) rho[i] = 1.0;
+	double lambda = 0.0;
+	start = now();
+	for (k=0; k<niter; k++)
+	{
+		xfer_apply (op, tmp, rho);
+		lambda = integrate (op, tmp) / integrate (op, rho);
+		double norm = 1.0 / integrate (op, tmp);
+		for (i=0; i<cnt; i++) rho[i] = norm * tmp[i];
+	}
+	printf ("# lambda_0 = %.15g\n", lambda);
+
+	/* The first decaying mode. Anything along rho creeps back in,
+	 * through discretization error, and so is removed every time. */
+	for (i=0; i<cnt; i++) den[i] = x[i] - 0.5;
+	for (k=0; k<niter; k++)
+	{
+		double c = integrate (op, den);
+		for (i=0; i<cnt; i++) den[i] -= c * rho[i];
+		xfer_apply (op, tmp, den);
+		lambda = dot (op, tmp, den) / dot (op, den, den);
+		double norm = 1.0 / sqrt (dot (op, tmp, tmp));
+		for (i=0; i<cnt; i++) den[i] = norm * tmp[i];
+	}
+	printf ("# lambda_1 = %.15g\n", lambda);
+	printf ("# %d iterations: %g secs\n", 2*niter, now()-start);
+
+	printf ("#\n# i	x	invariant	decaying\n");
+	for (i=0; i<cnt; i++)
+		printf ("%d	%.10g	%.15g	%.15g\n", i, x[i], rho[i], den[i]);
+
+	xfer_free (op);
+	return 0;
+}
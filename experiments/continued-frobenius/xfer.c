@@ -0,0 +1,368 @@
+/*
+ * xfer.c
+ *
+ * Discretized transfer operators; see xfer.h for an overview.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xfer.h"
+
+/* Runs of nonzero columns closer together than this are merged;
+ * a few multiplications by zero are cheaper than another run. */
+#define XFER_GAP 8
+
+/* For the Chebyshev grid, the Gauss map branches after this one are
+ * lumped together. The error in doing so goes like 1/n^5. */
+#define XFER_GAUSS_CHEB_BRANCHES 1000
+
+typedef struct
+{
+	int nruns;
+	int *start;      /* first column of each run */
+	int *len;        /* number of columns in each run */
+	double *val;     /* the coefficients, one run after another */
+} xfer_row;
+
+struct xfer_op_s
+{
+	xfer_map map;
+	double K;
+	xfer_grid grid;
+	int cnt;
+	double *x;       /* sample points */
+	double *quad;    /* quadrature weights */
+	double *bary;    /* barycentric weights, Chebyshev grid only */
+	xfer_row *rows;
+	long nnz;
+};
+
+/* ==================================================================== */
+/* Interpolation */
+
+/* Add w times the interpolation coefficients for the point y to row,
+ * so that the dot product of row with a sampled density is w times
+ * the density interpolated to y. The row must have room for 2*cnt
+ * doubles; the second half is scratch. */
+static void add_sample (const xfer_op *op, double *row, double y, double w)
+{
+	int cnt = op->cnt;
+	int k;
+
+	if (XFER_UNIFORM == op->grid)
+	{
+		double dj = y * ((double) cnt) - 0.5;
+		int j = floor (dj);
+		if (j < 0) j = 0;
+		if (cnt-2 < j) j = cnt-2;
+		double frac = dj - j;
+		row[j] += w * (1.0-frac);
+		row[j+1] += w * frac;
+		return;
+	}
+
+	/* The scratch space is the tail end of row. */
+	double *t = row + cnt;
+	double sum = 0.0;
+	for (k=0; k<cnt; k++)
+	{
+		double d = y - op->x[k];
+		if (0.0 == d)
+		{
+			row[k] += w;
+			return;
+		}
+		t[k] = op->bary[k] / d;
+		sum += t[k];
+	}
+	w /= sum;
+	for (k=0; k<cnt; k++)
+		row[k] += w * t[k];
+}
+
+double xfer_interpolate (const xfer_op *op, const double *den, double y)
+{
+	int cnt = op->cnt;
+	int k;
+
+	if (XFER_UNIFORM == op->grid)
+	{
+		double dj = y * ((double) cnt) - 0.5;
+		int j = floor (dj);
+		if (j < 0) j = 0;
+		if (cnt-2 < j) j = cnt-2;
+		double frac = dj - j;
+		return (1.0-frac) * den[j] + frac * den[j+1];
+	}
+
+	double num = 0.0;
+	double sum = 0.0;
+	for (k=0; k<cnt; k++)
+	{
+		double d = y - op->x[k];
+		if (0.0 == d) return den[k];
+		double t = op->bary[k] / d;
+		num += t * den[k];
+		sum += t;
+	}
+	return num / sum;
+}
+
+/* ==================================================================== */
+/* The maps. Each one adds all of the preimages of x to row. */
+
+/* Sum over n>=0 of (a+n)^-s, by Euler-Maclaurin. Good to double
+ * precision for a of a thousand or more. */
+static double hurwitz_tail (double s, double a)
+{
+	double as = pow (a, -s);
+	return a * as / (s-1.0) + 0.5 * as + s * as / (12.0 * a)
+	       - s * (s+1.0) * (s+2.0) * as / (720.0 * a*a*a);
+}
+
+static void gauss_row (const xfer_op *op, double *row, double x)
+{
+	/* Branch n maps [1/(n+1), 1/n] onto [0,1]; the preimage of x
+	 * is y = 1/(n+x), with weight y^2. */
+	int nmax = XFER_GAUSS_CHEB_BRANCHES;
+	if (XFER_UNIFORM == op->grid) nmax = 2*op->cnt + 1;
+
+	int n;
+	for (n=1; n<=nmax; n++)
+	{
+		double y = 1.0 / (((double) n) + x);
+		add_sample (op, row, y, y*y);
+	}
+
+	/* The rest of the branches are all squeezed up against zero,
+	 * in front of the first sample point. Replace them by two, at
+	 * the nodes of the two-point Gauss rule for their weights, so
+	 * that the total weight and the first three moments come out
+	 * right. On the uniform grid, where the interpolation there is
+	 * linear, this is exact. */
+	double a = ((double) nmax+1) + x;
+	double m0 = hurwitz_tail (2.0, a);
+	double m1 = hurwitz_tail (3.0, a);
+	double m2 = hurwitz_tail (4.0, a);
+	double m3 = hurwitz_tail (5.0, a);
+
+	/* The nodes are the roots of y^2 + p y + q, orthogonal to
+	 * 1 and y. */
+	double det = m0*m2 - m1*m1;
+	double p = (m1*m2 - m0*m3) / det;
+	double q = (m1*m3 - m2*m2) / det;
+	double disc = sqrt (0.25*p*p - q);
+	double y0 = -0.5*p - disc;
+	double y1 = -0.5*p + disc;
+	double w1 = (m1 - m0*y0) / (y1 - y0);
+	add_sample (op, row, y0, m0 - w1);
+	add_sample (op, row, y1, w1);
+}
+
+static void beta_row (const xfer_op *op, double *row, double x)
+{
+	/* As in beta-xform/rexfer.c, the density is zero above K. */
+	double K = op->K;
+	if (K < x) return;
+
+	double beta = 2.0 * K;
+	double y = x / beta;
+	add_sample (op, row, y, 1.0/beta);
+	y += 0.5;
+	if (y <= K) add_sample (op, row, y, 1.0/beta);
+}
+
+static void tent_row (const xfer_op *op, double *row, double x)
+{
+	double K = op->K;
+	if (K < x) return;
+
+	double beta = 2.0 * K;
+	double y = x / beta;
+	add_sample (op, row, y, 1.0/beta);
+	y = 1.0 - y;
+	if (y <= K) add_sample (op, row, y, 1.0/beta);
+}
+
+/* ==================================================================== */
+/* Setup */
+
+static void set_grid (xfer_op *op)
+{
+	int cnt = op->cnt;
+	int i, j;
+
+	op->x = malloc (cnt * sizeof(double));
+	op->quad = malloc (cnt * sizeof(double));
+	op->bary = NULL;
+
+	if (XFER_UNIFORM == op->grid)
+	{
+		for (i=0; i<cnt; i++)
+		{
+			op->x[i] = ((double) (2*i+1)) / ((double) (2*cnt));
+			op->quad[i] = 1.0 / ((double) cnt);
+		}
+		return;
+	}
+
+	op->bary = malloc (cnt * sizeof(double));
+	for (i=0; i<cnt; i++)
+	{
+		double theta = M_PI * ((double) (2*i+1)) / ((double) (2*cnt));
+		op->x[i] = 0.5 * (1.0 - cos (theta));
+		op->bary[i] = (i%2) ? -sin (theta) : sin (theta);
+
+		/* Fejer's first rule, halved for [0,1]. */
+		double acc = 1.0;
+		for (j=1; j<=cnt/2; j++)
+			acc -= 2.0 * cos (2*j*theta) / ((double) (4*j*j-1));
+		op->quad[i] = acc / ((double) cnt);
+	}
+}
+
+/* Save the nonzero stretches of row in r. */
+static void compact_row (xfer_row *r, const double *row, int cnt,
+                         int *start, int *len)
+{
+	int nruns = 0;
+	int nval = 0;
+	int c = 0;
+	int k;
+	while (c < cnt)
+	{
+		if (0.0 == row[c])
+		{
+			c++;
+			continue;
+		}
+		int end = c+1;
+		for (k=c+1; k<cnt && k-end < XFER_GAP; k++)
+			if (0.0 != row[k]) end = k+1;
+
+		start[nruns] = c;
+		len[nruns] = end - c;
+		nruns ++;
+		nval += end - c;
+		c = end;
+	}
+
+	r->nruns = nruns;
+	r->start = malloc ((nruns+1) * sizeof(int));
+	r->len = malloc ((nruns+1) * sizeof(int));
+	r->val = malloc ((nval+1) * sizeof(double));
+	memcpy (r->start, start, nruns * sizeof(int));
+	memcpy (r->len, len, nruns * sizeof(int));
+
+	double *v = r->val;
+	for (k=0; k<nruns; k++)
+	{
+		memcpy (v, &row[start[k]], len[k] * sizeof(double));
+		v += len[k];
+	}
+}
+
+xfer_op * xfer_new (xfer_map map, double K, xfer_grid grid, int cnt)
+{
+	if (cnt < 2) return NULL;
+
+	xfer_op *op = malloc (sizeof(xfer_op));
+	op->map = map;
+	op->K = K;
+	op->grid = grid;
+	op->cnt = cnt;
+	set_grid (op);
+	op->rows = malloc (cnt * sizeof(xfer_row));
+
+	long nnz = 0;
+#pragma omp parallel reduction(+:nnz)
+	{
+		double *row = malloc (2 * cnt * sizeof(double));
+		int *start = malloc (cnt * sizeof(int));
+		int *len = malloc (cnt * sizeof(int));
+		int i, k;
+
+#pragma omp for schedule(dynamic, 4)
+		for (i=0; i<cnt; i++)
+		{
+			memset (row, 0, cnt * sizeof(double));
+			double x = op->x[i];
+			switch (map)
+			{
+				case XFER_GAUSS: gauss_row (op, row, x); break;
+				case XFER_BETA:  beta_row (op, row, x); break;
+				case XFER_TENT:  tent_row (op, row, x); break;
+			}
+			compact_row (&op->rows[i], row, cnt, start, len);
+			for (k=0; k<op->rows[i].nruns; k++)
+				nnz += op->rows[i].len[k];
+		}
+
+		free (row);
+		free (start);
+		free (len);
+	}
+	op->nnz = nnz;
+
+	return op;
+}
+
+void xfer_free (xfer_op *op)
+{
+	if (NULL == op) return;
+
+	int i;
+	for (i=0; i<op->cnt; i++)
+	{
+		free (op->rows[i].start);
+		free (op->rows[i].len);
+		free (op->rows[i].val);
+	}
+	free (op->rows);
+	free (op->x);
+	free (op->quad);
+	free (op->bary);
+	free (op);
+}
+
+/* ==================================================================== */
+
+int xfer_size (const xfer_op *op) { return op->cnt; }
+const double * xfer_points (const xfer_op *op) { return op->x; }
+const double * xfer_weights (const xfer_op *op) { return op->quad; }
+long xfer_nnz (const xfer_op *op) { return op->nnz; }
+
+void xfer_apply (const xfer_op *op, double *tgt, const double *src)
+{
+	int i;
+
+	/* Small operators aren't worth waking up the other threads. */
+#pragma omp parallel for schedule(static) if (50000 < op->nnz)
+	for (i=0; i<op->cnt; i++)
+	{
+		const xfer_row *r = &op->rows[i];
+		const double *v = r->val;
+		double acc = 0.0;
+		int k;
+		for (k=0; k<r->nruns; k++)
+		{
+			const double *s = src + r->start[k];
+			int len = r->len[k];
+			double sum = 0.0;
+			int m;
+#pragma omp simd reduction(+:sum)
+			for (m=0; m<len; m++)
+				sum += v[m] * s[m];
+			acc += sum;
+			v += len;
+		}
+		tgt[i] = acc;
+	}
+}
+
+/* ========================== END OF FILE ============= */
@@ -0,0 +1,107 @@
+/*
+ * xfer.h
+ *
+ * Discretized transfer (Frobenius-Perron) operators, for power
+ * iteration on densities sampled on a grid of points in [0,1].
+ *
+ * Applying the operator to a sampled density means summing, at each
+ * sample point x, the density at every preimage y of x, times the
+ * weight 1/|T'(y)|, with the density interpolated between the sample
+ * points. The preimages, and so the interpolation indices and weights,
+ * depend only on the map and the grid, and not on the density. So
+ * they are worked out once, when the operator is created, and summed
+ * into one row of coefficients per sample point; applying the operator
+ * is then a matrix-vector product. For the Gauss map, this replaces
+ * the ten-thousand branch sum that perron() in frobenius.c did for
+ * every point, on every iteration.
+ *
+ * Each row is kept as a few runs of contiguous columns, so that the
+ * product is a handful of short dot products, which vectorize. Both
+ * setup and apply are spread over all cores with OpenMP, if compiled
+ * with -fopenmp; OMP_NUM_THREADS sets the number of threads.
+ *
+ * Two grids are supported:
+ * XFER_UNIFORM:   the midpoints (2i+1)/(2cnt), with linear
+ *                 interpolation (and extrapolation at the ends),
+ *                 just like frobenius.c.
+ * XFER_CHEBYSHEV: the Chebyshev points (1-cos((2i+1)pi/(2cnt)))/2,
+ *                 with barycentric polynomial interpolation. This
+ *                 converges spectrally for smooth densities, so a
+ *                 few dozen points do better than thousands of
+ *                 uniform ones. The rows are dense.
+ *
+ * And three maps:
+ * XFER_GAUSS: the continued fraction map x -> 1/x - floor(1/x).
+ *             The branches n > 2cnt (uniform) or n > 1000 (Chebyshev)
+ *             are summed in closed form; see gauss_row() in xfer.c.
+ * XFER_BETA:  the beta transform of beta-xform/, with beta=2K:
+ *             x -> 2Kx for x<1/2, and 2K(x-1/2) for x>=1/2.
+ * XFER_TENT:  the tent map of farey/tent, 2Kx for x<1/2,
+ *             and 2K(1-x) for x>=1/2.
+ * For the last two, 1/2 < K <= 1, and densities live on [0,K].
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __XFER_H__
+#define __XFER_H__
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+	XFER_UNIFORM,
+	XFER_CHEBYSHEV
+} xfer_grid;
+
+typedef enum
+{
+	XFER_GAUSS,
+	XFER_BETA,
+	XFER_TENT
+} xfer_map;
+
+typedef struct xfer_op_s xfer_op;
+
+/**
+ * xfer_new -- build the operator for map (with parameter K, ignored
+ * for the Gauss map) on a grid of cnt points.
+ */
+xfer_op * xfer_new (xfer_map map, double K, xfer_grid grid, int cnt);
+void xfer_free (xfer_op *op);
+
+/** Number of sample points. */
+int xfer_size (const xfer_op *op);
+
+/** The sample points, in increasing order. */
+const double * xfer_points (const xfer_op *op);
+
+/**
+ * Quadrature weights for the sample points, so that the sum of
+ * den[i]*weights[i] is the integral of the density over [0,1]:
+ * 1/cnt for the uniform grid, and Fejer's first rule for Chebyshev.
+ */
+const double * xfer_weights (const xfer_op *op);
+
+/** Number of stored coefficients; the cost of one xfer_apply(). */
+long xfer_nnz (const xfer_op *op);
+
+/**
+ * xfer_apply -- one iteration of the operator: tgt = L src.
+ * tgt and src must not overlap.
+ */
+void xfer_apply (const xfer_op *op, double *tgt, const double *src);
+
+/**
+ * xfer_interpolate -- the density den, sampled on the grid,
+ * interpolated to the point y, the same way xfer_apply() does.
+ */
+double xfer_interpolate (const xfer_op *op, const double *den, double y);
+
+#ifdef  __cplusplus
+};
+#endif
+
+#endif /* __XFER_H__ */
@@ -4,7 +4,8 @@
  * Call lapack from C code.
  *
  * Use LAPACK xSTEGR routine to find eigenvalues of tri-diagonal matrix.
- * specifically, use DSTEGR -- real double precision:
+ * specifically, use DSTEGR -- real double precision, by way of the
+ * mtx_d_stegr() adapter in ../continued-frobenius/mtx-lapack.c
  *
  * Apply to solve 1D Schroedinger equation
  *
@@ -16,7 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#include "lapack.h"
+#include "mtx.h"
 
 
 #if 0
@@ -45,39 +46,24 @@ getworkdim (int dim, double *diags,
 }
 #endif
 
+/* The eigenvectors come back in the columns of eigenvecs. */
 int 
 geteigen (int dim, double *diags,
         double *subdiags, 
-        double abstol,
         double *eigenvals,
-        double *eigenvecs,
-		  int *support)
+        mtx_d *eigenvecs)
 {
-	char jobz = 'V';
-	char range = 'A';
-	double vu=0.0, vl=1.0E30;
-	int il=0, iu=12345670;
-	int m;
-	int rworkdim, iworkdim;
-	double *rwork;
-	int * iwork;
-	int info;
-
-	rworkdim = 20*dim;
-	iworkdim = 10*dim;
-
-	rwork = (double *) malloc (rworkdim*sizeof (double));
-	iwork = (int *) malloc (iworkdim*sizeof (int));
-
-	dstegr_ (&jobz, &range, &dim, diags, subdiags,
-	         &vl, &vu, &il, &iu, &abstol,
-            &m, eigenvals, eigenvecs, &dim, 
-	         support, rwork, &rworkdim, iwork, &iworkdim,
-			   &info);
+	mtx_d *tri = mtx_d_new (dim, dim);
+	int i;
+	for (i=0; i<dim; i++)
+	{
+		MTX(tri,i,i) = diags[i];
+		if (i+1 < dim) MTX(tri,i+1,i) = subdiags[i];
+	}
 
-	free (iwork);
-	free (rwork);
+	int info = mtx_d_stegr (tri, eigenvals, eigenvecs);
 
+	mtx_d_free (tri);
 	return info;
 }
 
@@ -240,8 +226,7 @@ main (int argc, char * argv[])
 	double *diags;
 	double *subdiags;
 	double *eigenvals;
-	double *eigenvecs;
-	int * support;
+	mtx_d *eigenvecs;
 	int i,j, k;
 	
 	int kstep = 10;
@@ -255,7 +240,6 @@ main (int argc, char * argv[])
 	int eigen_prt = atoi(argv[2]);
 
 	int Mprec = 9;
-	double abstol=1.0e-6;
 	// int dim = centered_quadratic_dim (kstep, Mprec);
 	// int dim = one_sided_quadratic_dim (kstep, Mprec);
 	int dim = one_sided_linear_dim (kstep, Mprec);
@@ -263,8 +247,7 @@ main (int argc, char * argv[])
 	diags = (double *) malloc (dim*sizeof (double));
 	subdiags = (double *) malloc (dim*sizeof (double));
 	eigenvals = (double *) malloc (dim*sizeof (double));
-	eigenvecs = (double *) malloc (dim*dim*sizeof (double));
-	support = (int *) malloc (2*dim*sizeof (int));
+	eigenvecs = mtx_d_new (dim, dim);
 
 	double delta;
 	int ncenter;
@@ -272,8 +255,7 @@ main (int argc, char * argv[])
 	// elliptic_data (kstep, dim, diags, subdiags, &ncenter, &delta);
 	comb_data (kstep, dim, diags, subdiags, &ncenter, &delta);
 
-	geteigen (dim, diags, subdiags, abstol,
-        eigenvals, eigenvecs, support);
+	geteigen (dim, diags, subdiags, eigenvals, eigenvecs);
 
 	/* ---------------------------------------------- */
 
@@ -290,13 +272,12 @@ main (int argc, char * argv[])
 	printf ("\n\n");
 	
 	/* Print the eigenvectors */
-	/* Note transposed matrix'ing for FORTRAN */
 	for (j=0; j<dim; j++)
 	{
 		printf ("%d	%g	%g", j, (j-ncenter)*delta, comb_potential(j, delta));
 		for (i=eigen_prt; i<9+eigen_prt; i++)
 		{
-			printf ("\t%g", eigenvecs[j+i*dim]);
+			printf ("\t%g", MTX(eigenvecs,j,i));
 		}
 		printf ("\n");
 	}
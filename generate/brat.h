@@ -33,6 +33,13 @@ void MakeHisto (
    int		itermax,
 	double 	renorm);
 
+/**
+ * brat_out_name -- the output file name, as given on the command
+ * line. For a MakeHisto that makes more images than the one in glob:
+ * it can write them with Fopen(brat_out_name, "-<suffix>.flo").
+ */
+extern const char *brat_out_name;
+
 /**
  * MakeHeightCB - callback for making a plain height-map.
  *
@@ -40,7 +47,9 @@ void MakeHisto (
  * DECL_MAKE_HEIGHT() to run it.
  *
  * The callback should return a single real number, given, as input,
- * a fixed point (x,y) on the 2D plane.
+ * a fixed point (x,y) on the 2D plane. With --aa, it is also called
+ * at points in between the pixels, where the image is not smooth;
+ * see supersample.h.
  */
 typedef double MakeHeightCB
 	(double x, double y, int itermax, double param);
@@ -115,6 +124,100 @@ void MakeHisto (        \
        width, height, itermax, renorm, cb);                  \
 }
 
+/**
+ * MakeHeightBatchCB - height-map callback that does many pixels at once.
+ *
+ * Same as MakeHeightCB, except that it is handed arrays of npts
+ * points (x[k], y[k]), and should fill in out[k] for each. The points
+ * are consecutive pixels of one row of one tile. This allows the
+ * callback to run several pixels through a vectorized kernel at the
+ * same time (see series.h). Use DECL_MAKE_HEIGHT_BATCH() to run it.
+ * The callback is called from many threads at once.
+ */
+typedef void MakeHeightBatchCB
+	(const double *x, const double *y, double *out, int npts,
+	 int itermax, double param);
+
+void
+MakeHeightBatchWrap (
+   float  	*glob,
+   int 		sizex,
+   int 		sizey,
+   double	re_center,
+   double	im_center,
+   double	width,
+   double	height,
+   int		itermax,
+   double 	renorm,
+	MakeHeightBatchCB cb);
+
+#define DECL_MAKE_HEIGHT_BATCH(cb)  \
+void MakeHisto (        \
+   char     *name,      \
+   float  	*glob,      \
+   int 		sizex,      \
+   int 		sizey,      \
+   double	re_center,  \
+   double	im_center,  \
+   double	width,      \
+   double	height,     \
+   int		itermax,    \
+	double 	renorm)     \
+{                       \
+   MakeHeightBatchWrap (glob, sizex, sizey, re_center, im_center,  \
+       width, height, itermax, renorm, cb);                  \
+}
+
+/**
+ * MakeHeightThreadCB - per-thread setup and teardown for height maps.
+ *
+ * MakeHeightWrap runs the height callback on many threads at once,
+ * so any scratch state that the callback keeps (e.g. GMP variables)
+ * must be per-thread: declare it "static thread_local", initialize
+ * it in the init hook, and clear it in the fini hook. Then use
+ * DECL_MAKE_HEIGHT_TLS() instead of DECL_MAKE_HEIGHT().
+ *
+ * The init hook is called once in every worker thread before any
+ * pixels are computed; the fini hook once in every worker thread
+ * after all pixels are done. The hooks are called one at a time,
+ * so they can safely set global state, such as the GMP default
+ * precision. They are passed the same itermax and param as the
+ * height callback.
+ */
+typedef void MakeHeightThreadCB (int itermax, double param);
+
+void
+MakeHeightWrapTLS (
+   float  	*glob,
+   int 		sizex,
+   int 		sizey,
+   double	re_center,
+   double	im_center,
+   double	width,
+   double	height,
+   int		itermax,
+   double 	renorm,
+	MakeHeightCB cb,
+	MakeHeightThreadCB init,
+	MakeHeightThreadCB fini);
+
+#define DECL_MAKE_HEIGHT_TLS(cb,init,fini)  \
+void MakeHisto (        \
+   char     *name,      \
+   float  	*glob,      \
+   int 		sizex,      \
+   int 		sizey,      \
+   double	re_center,  \
+   double	im_center,  \
+   double	width,      \
+   double	height,     \
+   int		itermax,    \
+	double 	renorm)     \
+{                       \
+   MakeHeightWrapTLS (glob, sizex, sizey, re_center, im_center,  \
+       width, height, itermax, renorm, cb, init, fini);          \
+}
+
 /**
  * MakeBifurCB- Bifurcation diagram callback, does one row at a time.
  *
@@ -164,3 +267,93 @@ void MakeHisto (        \
    MakeBifurWrap (glob, sizex, sizey, re_center, im_center,  \
        width, height, itermax, renorm, cb);                  \
 }
+
+/**
+ * DECL_MAKE_BIFUR_PARALLEL -- same as DECL_MAKE_BIFUR, but the rows
+ * are computed concurrently, on the tile scheduler's thread pool.
+ *
+ * Reentrancy contract: the callback may be called for several rows
+ * at the same time, and in any order. It must not keep any state
+ * from one row to the next (no static variables, no rand(); use
+ * rand_r() with a seed derived from y_parameter) and it must write
+ * only into the array it was handed.
+ */
+void
+MakeBifurParallelWrap (
+	float    *glob,
+	int      sizex,
+	int      sizey,
+	double   re_center,
+	double   im_center,
+	double   width,
+	double   height,
+	int      itermax,
+	double   renorm,
+	MakeBifurCB cb);
+
+#define DECL_MAKE_BIFUR_PARALLEL(cb)  \
+void MakeHisto (        \
+   char     *name,      \
+   float  	*glob,      \
+   int 		sizex,      \
+   int 		sizey,      \
+   double	re_center,  \
+   double	im_center,  \
+   double	width,      \
+   double	height,     \
+   int		itermax,    \
+	double 	renorm)     \
+{                       \
+   MakeBifurParallelWrap (glob, sizex, sizey, re_center, im_center,  \
+       width, height, itermax, renorm, cb);                  \
+}
+
+/**
+ * MakeBifurPrefixCB -- sequential-prefix bifurcation callback.
+ *
+ * For diagrams where each row continues from where the previous row
+ * left off (e.g. running sums over the integers). The callback is
+ * called once per row, strictly in order, from a single thread. It
+ * should generate up to max_samples points, each in the range [0,1),
+ * and store them in samples[]. It returns the number of samples
+ * generated. The histogramming of the samples into the row is done
+ * concurrently, on other threads, while the callback is busy
+ * generating the following rows.
+ */
+typedef int
+MakeBifurPrefixCB (
+	double *samples,
+	int max_samples,
+	double y_parameter,
+	int itermax,
+	double renorm);
+
+void
+MakeBifurPrefixWrap (
+	float    *glob,
+	int      sizex,
+	int      sizey,
+	double   re_center,
+	double   im_center,
+	double   width,
+	double   height,
+	int      itermax,
+	double   renorm,
+	MakeBifurPrefixCB cb);
+
+#define DECL_MAKE_BIFUR_PREFIX(cb)  \
+void MakeHisto (        \
+   char     *name,      \
+   float  	*glob,      \
+   int 		sizex,      \
+   int 		sizey,      \
+   double	re_center,  \
+   double	im_center,  \
+   double	width,      \
+   double	height,     \
+   int		itermax,    \
+	double 	renorm)     \
+{                       \
+   MakeBifurPrefixWrap (glob, sizex, sizey, re_center, im_center,  \
+       width, height, itermax, renorm, cb);                  \
+}
@@ -0,0 +1,303 @@
+/*
+ * cfperm.h
+ *
+ * FUNCTION:
+ * Permutations of the partial quotients of continued fractions.
+ *
+ * Given x = [0; a_1, a_2, a_3, ...] and a permutation P of 1...k,
+ * the map x -> [0; a_P(1), a_P(2), ... a_P(k), a_{k+1}, ...] reorders
+ * the first k partial quotients, and leaves the rest alone. swap.C
+ * integrates these maps against x^s. The permutation is a template
+ * parameter: CFPerm<2,1> exchanges a_1 and a_2, CFPerm<4,2,3,1>
+ * exchanges a_1 and a_4, and so on. The loops over it are unrolled
+ * by the compiler.
+ *
+ * The quotients of x are peeled off just once, by cf_expand(), and
+ * any number of permutations are then applied to the same expansion.
+ * The arithmetic is templated on the number type: long double,
+ * double, or a vector of CF_LANES doubles, which does that many x at
+ * once. In long double, the results are bit-identical to the swap12(),
+ * swap13() etc. that swap.C used to spell out by hand, except near the
+ * rationals (see cf_expand()). In double, rounding moves the cutoff at
+ * rationals with large quotients, so swap.C integrates in long double.
+ * The self-test at the bottom checks the double path.
+ *
+ * HISTORY:
+ * permutation kernels -- October 2026
+ */
+
+#ifndef __BRAT_CFPERM_H__
+#define __BRAT_CFPERM_H__
+
+#include <math.h>
+
+/**
+ * Number of doubles handled at once by cf_permute_batch(). Two fill
+ * an SSE2 register; four an AVX register, when compiled with -mavx
+ * or better. As in regulated.h.
+ */
+#ifndef CF_LANES
+#ifdef __AVX__
+#define CF_LANES 4
+#else
+#define CF_LANES 2
+#endif
+#endif
+
+/* Remainders closer than this to zero or one end the expansion. */
+#define CF_EPS 1.0e-10
+
+typedef double cf_vdouble __attribute__ ((vector_size (8*CF_LANES)));
+
+/**
+ * cf_floor -- floorl() for long double. For doubles, and vectors of
+ * them, add and subtract 2^52; that rounds exactly for 0 <= x < 2^52,
+ * and vectorizes, where floor() would not without SSE4.1. Anything
+ * bigger is an integer already.
+ */
+static inline long double cf_floor (long double x) { return floorl (x); }
+
+template <typename V>
+static inline V cf_floor (V x)
+{
+	const double big = 4503599627370496.0;  /* 2^52 */
+	V t = (x + big) - big;
+	t = (t > x) ? t - 1.0 : t;
+	return (x < big) ? t : x;
+}
+
+/**
+ * CFExpansion -- the first K partial quotients a_1 ... a_K of x, and
+ * the remainders r_j = [0; a_{j+1}, a_{j+2}, ...], so that
+ * x = 1/(a_1 + r_1), r_1 = 1/(a_2 + r_2), and so on.
+ */
+template <typename V, int K>
+struct CFExpansion
+{
+	V a[K];
+	V r[K];
+};
+
+/**
+ * cf_expand -- peel off the first K quotients of x, for 0 < x <= 1.
+ *
+ * If a remainder r_j, for j < K, is below CF_EPS, then x is taken to
+ * be rational, and the quotients after a_j infinite. If r_j is within
+ * CF_EPS of one, it is taken to be a rounding error: a_j is bumped up
+ * by one and r_j down by one, which leaves x as it was, and again the
+ * quotients after a_j are infinite. An infinite quotient cuts the
+ * continued fraction off, wherever the permutation moves it to. The
+ * last remainder, r_K, is not checked.
+ */
+template <typename V, int K>
+static inline void cf_expand (V x, CFExpansion<V,K> *cf)
+{
+	const V zero = V();
+	const V inf = zero + (double) HUGE_VAL;
+	auto done = (zero != zero);
+	V r = x;
+	for (int j=0; j<K; j++)
+	{
+		V ox = 1.0 / r;
+		V a = cf_floor (ox);
+		r = ox - a;
+		a = done ? inf : a;
+		r = done ? zero : r;
+		if (j < K-1)
+		{
+			auto near1 = ((1.0 - r) < CF_EPS);
+			a = near1 ? a + 1.0 : a;
+			r = near1 ? r - 1.0 : r;
+			done = done | near1 | (r < CF_EPS);
+		}
+		cf->a[j] = a;
+		cf->r[j] = r;
+	}
+}
+
+/**
+ * CFPerm -- the permutation P(1), ... P(k) of the first k quotients.
+ * apply() puts the quotients of an expansion back together, in the
+ * permuted order, from the inside out.
+ */
+template <int... P>
+struct CFPerm
+{
+	static const int k = sizeof... (P);
+
+	template <typename V, int K>
+	static inline V apply (const CFExpansion<V,K>& cf)
+	{
+		static_assert (k <= K, "expansion is shorter than the permutation");
+		const int p[] = {P...};
+		V y = cf.r[k-1];
+		for (int i=k-1; 0<=i; i--)
+			y = 1.0 / (y + cf.a[p[i]-1]);
+		return y;
+	}
+};
+
+/* The longest of a list of permutations. */
+template <typename... Perms> struct CFMaxLen;
+template <> struct CFMaxLen<> { static const int k = 1; };
+template <typename P, typename... Rest>
+struct CFMaxLen<P, Rest...>
+{
+	static const int k = (P::k > CFMaxLen<Rest...>::k) ? P::k : CFMaxLen<Rest...>::k;
+};
+
+/* Loading and storing a lane's worth of T. */
+template <typename T>
+struct CFLanes
+{
+	typedef T V;
+	static const int n = 1;
+	static V load (const T *x, int) { return x[0]; }
+	static void store (V v, T *out, int) { out[0] = v; }
+};
+
+template <>
+struct CFLanes<double>
+{
+	typedef cf_vdouble V;
+	static const int n = CF_LANES;
+	static V load (const double *x, int nl)
+	{
+		V v;
+		for (int l=0; l<CF_LANES; l++) v[l] = (l < nl) ? x[l] : 0.5;
+		return v;
+	}
+	static void store (V v, double *out, int nl)
+	{
+		for (int l=0; l<nl; l++) out[l] = v[l];
+	}
+};
+
+/**
+ * cf_permute_batch -- apply each of the permutations Perms... to the
+ * n points x[i], putting the result of the m'th one in out[m][i].
+ * Each x is expanded once, as deep as the longest permutation needs,
+ * and all of the permutations work from that one expansion. T is
+ * long double, or double, which is done CF_LANES points at a time.
+ */
+template <typename T, typename... Perms>
+void cf_permute_batch (int n, const T *x, T *const *out)
+{
+	typedef CFLanes<T> L;
+	typedef typename L::V V;
+	const int K = CFMaxLen<Perms...>::k;
+	CFExpansion<V,K> cf;
+
+	for (int i=0; i<n; i += L::n)
+	{
+		int nl = (i + L::n <= n) ? L::n : n - i;
+		cf_expand (L::load (&x[i], nl), &cf);
+		int m = 0;
+		int order[] = { (L::store (Perms::apply (cf), &out[m++][i], nl), 0)... };
+		(void) order;
+	}
+}
+
+#ifdef TEST
+/*
+ * Self-test of the double path. The vector kernel must match the
+ * scalar double one bit for bit, on every point, including the partial
+ * batch at the end of the array. Away from the rationals, it must also
+ * agree with long double. At a rational with quotients of size a, the
+ * double remainders are off by about a^2 * 1e-16, which can exceed
+ * CF_EPS; there, double and long double may cut the fraction off at
+ * different places, and are not compared.
+ * Build and run with
+ *    c++ -std=gnu++11 -O2 -DTEST -x c++ cfperm.h -o cfperm-test && ./cfperm-test
+ */
+#include <stdio.h>
+
+#define CF_TEST_PERMS CFPerm<2,1>, CFPerm<3,2,1>, CFPerm<1,3,2>, CFPerm<4,2,3,1>
+#define CF_TEST_NPERMS 4
+
+template <typename... Perms>
+void cf_permute_scalar (int n, const double *x, double *const *out)
+{
+	const int K = CFMaxLen<Perms...>::k;
+	CFExpansion<double,K> cf;
+	for (int i=0; i<n; i++)
+	{
+		cf_expand (x[i], &cf);
+		int m = 0;
+		int order[] = { (out[m++][i] = Perms::apply (cf), 0)... };
+		(void) order;
+	}
+}
+
+int test_cf_lanes (int n)
+{
+	int have_error = 0;
+	long double xl[n], yl[CF_TEST_NPERMS][n];
+	double xd[n], yd[CF_TEST_NPERMS][n+1], ys[CF_TEST_NPERMS][n];
+	long double *pl[CF_TEST_NPERMS];
+	double *pd[CF_TEST_NPERMS], *ps[CF_TEST_NPERMS];
+
+	/* Odd points on a grid of rationals, even ones pseudo-random. */
+	unsigned long seed = 12345;
+	for (int i=0; i<n; i++)
+	{
+		if (i%2) xd[i] = (i + 1.0) / (n + 1.0);
+		else
+		{
+			seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+			xd[i] = ((seed >> 11) + 1.0) / 9007199254740993.0;
+		}
+		xl[i] = xd[i];
+	}
+	for (int m=0; m<CF_TEST_NPERMS; m++)
+	{
+		pl[m] = yl[m];
+		pd[m] = yd[m];
+		ps[m] = ys[m];
+		yd[m][n] = -1.0;
+	}
+
+	cf_permute_batch<long double, CF_TEST_PERMS> (n, xl, pl);
+	cf_permute_batch<double, CF_TEST_PERMS> (n, xd, pd);
+	cf_permute_scalar<CF_TEST_PERMS> (n, xd, ps);
+
+	for (int m=0; m<CF_TEST_NPERMS; m++)
+	{
+		if (-1.0 != yd[m][n])
+		{
+			printf ("ERROR: perm %d wrote past the end, n=%d\n", m, n);
+			have_error ++;
+		}
+		for (int i=0; i<n; i++)
+		{
+			if (yd[m][i] != ys[m][i])
+			{
+				printf ("ERROR: perm %d at x=%.17g: vector=%.17g scalar=%.17g\n",
+				        m, xd[i], yd[m][i], ys[m][i]);
+				have_error ++;
+			}
+			if (0 == i%2 && 1.0e-9 < fabsl (yl[m][i] - yd[m][i]))
+			{
+				printf ("ERROR: perm %d at x=%.17g: long double=%.17Lg double=%.17g\n",
+				        m, xd[i], yl[m][i], yd[m][i]);
+				have_error ++;
+			}
+		}
+	}
+
+	if (0 == have_error)
+		printf ("PASS: %d lanes of double, n=%d\n", CF_LANES, n);
+	return have_error;
+}
+
+int main()
+{
+	int have_error = 0;
+	have_error += test_cf_lanes (1);
+	have_error += test_cf_lanes (CF_LANES+1);
+	have_error += test_cf_lanes (10001);
+	return have_error;
+}
+#endif /* TEST */
+
+#endif /* __BRAT_CFPERM_H__ */
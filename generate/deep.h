@@ -0,0 +1,155 @@
+/*
+ * deep.h
+ *
+ * FUNCTION:
+ * Deep zooms of the Mandelbrot set, by perturbation theory.
+ *
+ * Past a width of about 1e-13, neighbouring pixels no longer differ
+ * in a double, and the escape-time images dissolve into blocks. With
+ * --deep, only one orbit, that of the center of the image, is done in
+ * high precision, with GMP, to as many bits as the zoom needs. Every
+ * other pixel, at c = C + dc, is done in double, as the small
+ * difference dz between its orbit and the reference one:
+ *
+ *    dz -> 2 Z dz + dz^2 + dc
+ *
+ * which needs no more bits than dc does, so that a 1e-100 zoom runs
+ * at close to the speed of an ordinary double-precision one.
+ *
+ * Glitches: where the reference orbit Z passes close to zero, dz
+ * stops being small next to the pixel's own orbit Z+dz, and the
+ * differences lose all of their precision. Those are caught by the
+ * test |Z+dz| < |dz|, and cured by rebasing: the pixel's orbit is
+ * restarted against the start of the reference orbit, with dz = Z+dz,
+ * which is small again. The same is done when a pixel outlives the
+ * reference orbit, so the center need not lie in the set.
+ *
+ * Series approximation: for the first n iterations, dz is very nearly
+ * the cubic A_n dc + B_n dc^2 + C_n dc^3, whose coefficients follow
+ * from the reference orbit alone. With the series turned on, the
+ * largest n for which the cubic holds, to about 1 part in 1e12,
+ * everywhere in the image, is found once, and all pixels start from
+ * there. At deep zooms, this skips most of the iterations.
+ *
+ * The widths reachable are limited by the range of a double: dc and
+ * dz must stay above 1e-300 or so.
+ *
+ * Users: the escape-time render of brat (mandelbrot_out) and the
+ * stalks of stalk (mandelbrot_stalk), in brat.C, and the bud-radius
+ * probes of radius, automatic and survey, in radius.C. The other
+ * programs refuse --deep. The stalks and the radius probes look at
+ * every iterate, not just the last, and so go through Orbit(), which
+ * does not use the series. Even at shallow zooms, the perturbed
+ * orbits are not bit-identical to the direct ones: near the edge of
+ * the set, where the orbits are chaotic, the escape counts of a few
+ * percent of the pixels come out different.
+ *
+ * HISTORY:
+ * deep zoom -- October 2026
+ */
+
+#ifndef __BRAT_DEEP_H__
+#define __BRAT_DEEP_H__
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <gmp.h>
+
+/**
+ * Non-zero for the deep-zoom mode. Set from the environment variable
+ * BRAT_DEEP, and on the command line by --deep.
+ */
+extern int deep_enabled;
+
+/**
+ * Non-zero to skip iterations with the series approximation. Set
+ * from the environment variable BRAT_DEEP_SERIES, and on the command
+ * line by --series or --no-series; the default is 1.
+ */
+extern int deep_series;
+
+/**
+ * deep_options -- strip --deep, --series and --no-series out of argv,
+ * the same way that tile_options() does.
+ */
+void deep_options (int *argc, char *argv[]);
+
+/**
+ * deep_center -- the center of the image, as decimal strings, as
+ * given on the command line. Needed because the double that atof()
+ * makes of them is not nearly precise enough. If never called, the
+ * center passed to DeepOrbit is used.
+ */
+void deep_center (const char *re_center, const char *im_center);
+
+/**
+ * DeepVisitFn -- called by DeepOrbit::Orbit() with each iterate z_n,
+ * n = 1, 2, ..., of one point, as re + i im. Returns false to stop.
+ */
+typedef std::function<bool (int n, double re, double im)> DeepVisitFn;
+
+/**
+ * DeepOrbit -- the reference orbit of the center, and the series
+ * coefficients. Made once per image, before the tiles are handed out,
+ * and then shared, read-only, by all threads.
+ */
+class DeepOrbit
+{
+	public:
+		/**
+		 * Iterate the center (re_center, im_center, unless set by
+		 * deep_center()) up to itermax times, with enough bits to
+		 * resolve pixel, the width of one pixel. dmax is the
+		 * largest |dc| in the image, for the series approximation;
+		 * zero if only Orbit() will be used. esq is the square of
+		 * the escape radius.
+		 */
+		DeepOrbit (double re_center, double im_center, double pixel,
+		           int itermax, double esq, double dmax);
+
+		/**
+		 * Points -- the loop of escape_points() (see escape.h), for
+		 * the npts points c = center + dc: for loop = 1, 2, ...
+		 * itermax-1, z = z^2 + c, stopping once |z|^2 > esq. Returns
+		 * the loop count at which each stopped (itermax if it
+		 * didn't), the final z, and the final |z|^2.
+		 */
+		void Points (int npts, const double *re_dc, const double *im_dc,
+		             int *loop, double *re, double *im, double *modulus);
+
+		/**
+		 * Orbit -- the orbit of the one point c = center + dc, an
+		 * iterate at a time: visit is called with z_1 = c, z_2 ...
+		 * up to z_itermax, until it returns false, or z escapes.
+		 * Returns n if z_n was the first iterate with |z|^2 > esq
+		 * (it is not visited), and zero otherwise. Safe to call
+		 * from many threads at once.
+		 */
+		int Orbit (double re_dc, double im_dc, DeepVisitFn visit);
+
+		/** Report -- print the precision, skip and glitch counts. */
+		void Report (void);
+
+	private:
+		int itermax;
+		double esq;
+		int bits;                  /* precision of the reference */
+		std::vector<double> zre;   /* the reference orbit, Z_0 = 0 */
+		std::vector<double> zim;
+		int nref;                  /* Z_nref is the last one */
+
+		/* Series approximation: all pixels start at Z_nskip, with
+		 * dz = A dc + B dc^2 + C dc^3 */
+		int nskip;
+		double are, aim, bre, bim, cre, cim;
+
+		std::atomic<long> nrebase;
+		std::atomic<long> npoints;
+
+		void Reference (const char *re_center, const char *im_center);
+		void Series (double dmax);
+};
+
+#endif /* __BRAT_DEEP_H__ */
@@ -0,0 +1,95 @@
+/*
+ * escape.h
+ *
+ * FUNCTION:
+ * Vectorized escape-time engine for z^2+c, with interior shortcuts.
+ *
+ * The escape-time renders in brat.C iterate z^2+c one pixel at a
+ * time, and pixels inside the Mandelbrot set run all the way to
+ * itermax. The kernels here iterate ESCAPE_LANES pixels at once, in
+ * lock-step, each lane masked off as it escapes. Two shortcuts stop
+ * interior pixels early:
+ *
+ *  -- points in the main cardioid or the period-2 bulb never escape,
+ *     and are not iterated at all;
+ *  -- Brent's cycle detection: z is saved at iterations 1, 2, 4, 8...
+ *     and compared, bit for bit, with every z after that. An orbit
+ *     that has settled into an attracting cycle lands exactly on a
+ *     saved value sooner or later, and from then on repeats exactly,
+ *     so it would not have escaped either.
+ *
+ * Escaping lanes do the same arithmetic, in the same order, as the
+ * scalar loops, so the escape counts and the final z (and dz/dc) are
+ * bit-identical to them; the interior points report itermax, as the
+ * scalar loops would have. The one exception is that a point that
+ * the cardioid or bulb test puts inside, but whose floating-point
+ * orbit drifts out anyway, is still called inside; that takes a point
+ * within a few ulps of the boundary.
+ *
+ * HISTORY:
+ * escape-time engine -- October 2026
+ */
+
+#ifndef __BRAT_ESCAPE_H__
+#define __BRAT_ESCAPE_H__
+
+/**
+ * Number of pixels handled at once. Four doubles fill an AVX2
+ * register, eight fill an AVX-512 register; compile with -mavx2 or
+ * -mavx512f to get the wide instructions. As in series.h.
+ */
+#ifndef ESCAPE_LANES
+#define ESCAPE_LANES 4
+#endif
+
+/* Overflow guard of iterate(): rescale z and dz/dc by 1/DOFL when
+ * they get past OFL. */
+#define OFL  (1e180)
+#define DOFL  (1e20)
+
+/**
+ * If zero, the cardioid, bulb and cycle shortcuts are turned off,
+ * and every interior point runs to itermax. For checking the
+ * shortcuts. Set from the environment variable BRAT_ESCAPE_SHORTCUTS;
+ * the default is 1.
+ */
+extern int escape_shortcuts;
+
+/**
+ * escape_inside -- true if c is in the main cardioid or in the
+ * period-2 bulb.
+ */
+static inline bool escape_inside (double re_c, double im_c)
+{
+	double x = re_c - 0.25;
+	double y2 = im_c * im_c;
+	double q = x*x + y2;
+	if (q * (q + x) <= 0.25 * y2) return true;
+	double xb = re_c + 1.0;
+	return xb*xb + y2 <= 0.0625;
+}
+
+/**
+ * escape_points -- the plain escape-time loop of mandelbrot_out():
+ * z starts at c, and for loop = 1, 2, ... itermax-1, z = z^2 + c,
+ * stopping once |z|^2 > esq. For each of the npts points c, returns
+ * the loop count at which it stopped (itermax if it didn't), the
+ * final z, and the final |z|^2.
+ */
+void escape_points (int npts, const double *re_c, const double *im_c,
+                    int itermax, double esq,
+                    int *loop, double *re, double *im, double *modulus);
+
+/**
+ * escape_deriv_points -- the loop of iterate(): z and dz/dc start at
+ * zero, and for loop = 1, 2, ... itermax, dz = 2 z dz + 1 and then
+ * z = z^2 + c, rescaling z and dz by 1/DOFL whenever re or im goes
+ * over OFL, and stopping once |z|^2 > esq. For each point, returns
+ * the iteration count (as iterate() returns it in itermax), and the
+ * final z and dz.
+ */
+void escape_deriv_points (int npts, const double *re_c, const double *im_c,
+                          int itermax, double esq, int *count,
+                          double *re, double *im, double *dre, double *dim);
+
+#endif /* __BRAT_ESCAPE_H__ */
@@ -0,0 +1,153 @@
+/*
+ * orbit.h
+ *
+ * FUNCTION:
+ * Multi-threaded orbit histograms for the brat.h generators.
+ *
+ * Scatterplots of orbits -- the standard map, the interior of the
+ * circle map, the Buddhabrot-like measure of the Mandelbrot set --
+ * throw each point of each orbit into a pixel of one big array. To
+ * run the orbits on many threads at once, each thread gets a private
+ * copy of the histogram, and the copies are summed at the end, a
+ * band of rows per thread. When the copies would not fit in memory,
+ * the histogram is instead cut into shards of rows, shared by all of
+ * the threads: each thread queues up the pixels that it hits, shard
+ * by shard, and adds them in under the shard's lock, a batch at a
+ * time.
+ *
+ * Each orbit (each "sample") gets its own random stream, keyed by the
+ * seed and by the sample number, and not by the thread that happens
+ * to run it, so that the same seed gives the same picture for any
+ * number of threads. With 64-bit counts, the picture is bit-for-bit
+ * the same; with float bins, the sums are done in a different order,
+ * and so may differ in the last bit.
+ *
+ * HISTORY:
+ * orbit histograms -- October 2026
+ */
+
+#ifndef __BRAT_ORBIT_H__
+#define __BRAT_ORBIT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+/**
+ * The random seed; the same seed gives the same picture. Set from
+ * the environment variable BRAT_SEED, and overridden on the command
+ * line by --seed=<n>. The default is 1.
+ */
+extern unsigned long orbit_seed;
+
+/**
+ * If non-zero, the histogram is kept as 64-bit integer counts of the
+ * hits, which are only scaled to floats at the very end. Otherwise,
+ * (the default) each hit adds the normalization to a float bin, as
+ * the single-threaded code always did; this is half the memory, but
+ * a float bin stops growing once it holds about 2^24 hits' worth.
+ * Set from BRAT_COUNTS64, and overridden by --counts64.
+ */
+extern int orbit_counts64;
+
+/**
+ * Memory budget, in megabytes, for the private per-thread copies of
+ * the histogram. If the copies need more than this, the histogram is
+ * sharded instead. Set from BRAT_HISTO_MB; the default is 2048. The
+ * --shard flag forces sharding, whatever the size.
+ */
+extern int orbit_histo_mb;
+extern int orbit_shard;
+
+/**
+ * orbit_options -- strip the options above out of argv, the same
+ * way that tile_options() does.
+ */
+void orbit_options (int *argc, char *argv[]);
+
+/**
+ * OrbitRng -- splitmix64, one stream per sample.
+ */
+class OrbitRng
+{
+	public:
+		OrbitRng (unsigned long seed, long sample)
+		{
+			state = Mix (seed + 0x9e3779b97f4a7c15ULL * (uint64_t) sample);
+		}
+
+		uint64_t Next (void)
+		{
+			state += 0x9e3779b97f4a7c15ULL;
+			return Mix (state);
+		}
+
+		/** Uniform on [0,1), 53 bits. */
+		double Uniform (void)
+		{
+			return (Next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+	private:
+		uint64_t state;
+		static uint64_t Mix (uint64_t z)
+		{
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+};
+
+struct OrbitShards;
+class OrbitSink;
+
+/**
+ * OrbitFn -- trace one orbit. Called once for every sample number,
+ * 0 <= sample < nsamples, from many threads at once. It should draw
+ * its starting point from rng, and call sink.Hit() for every point
+ * of the orbit that lands in the picture. It must not use rand() or
+ * drand48(), nor keep any state from one call to the next.
+ */
+typedef std::function<void (OrbitSink& sink, OrbitRng& rng, long sample)> OrbitFn;
+
+/**
+ * OrbitSink -- where one thread's orbit points go.
+ */
+class OrbitSink
+{
+	public:
+		/** One hit at column i, row j; out-of-range hits are dropped. */
+		void Hit (int i, int j)
+		{
+			if ((unsigned) i >= (unsigned) sizex ||
+			    (unsigned) j >= (unsigned) sizey) return;
+			size_t k = (size_t) j * sizex + i;
+			if (counts) counts[k] ++;
+			else if (bins) bins[k] += weight;
+			else Defer (k);
+		}
+
+	private:
+		friend void RunOrbits (float *, int, int, long, double, OrbitFn);
+
+		int sizex, sizey;
+		float *bins;
+		float weight;
+		uint64_t *counts;
+
+		OrbitShards *shards;
+		size_t *pending;
+		int *npending;
+		void Defer (size_t k);
+		void Flush (int s);
+};
+
+/**
+ * RunOrbits -- histogram nsamples orbits into the sizex by sizey
+ * array glob. On return, glob holds the number of hits in each
+ * pixel, times norm. Pixel (i, j) is glob[j*sizex + i].
+ */
+void RunOrbits (float *glob, int sizex, int sizey,
+                long nsamples, double norm, OrbitFn fn);
+
+#endif /* __BRAT_ORBIT_H__ */
@@ -0,0 +1,105 @@
+/*
+ * profile.h
+ *
+ * FUNCTION:
+ * Render profiler for the brat.h height maps and bifurcation diagrams.
+ *
+ * With --profile, the wrappers time every call to the callback with
+ * the CPU's cycle counter, and charge the cycles to the pixel that
+ * the call was for. Callbacks can also report how many iterations
+ * each point took, by calling prof_iterations(). At the end of the
+ * run, the per-pixel cycles and iterations are written out as a
+ * second, two-channel raster, <name>-cost.rst, next to the image,
+ * and a summary of the throughput, the spread of the cost per pixel,
+ * the most expensive tiles, and the utilization of each thread is
+ * printed to stderr. The cost raster can be viewed like any other,
+ * to see where the time goes, and so to tune itermax and param, or
+ * to judge where adaptive sampling (--aa) will pay.
+ *
+ * Without --profile, none of this costs anything but a test of
+ * prof_enabled per tile.
+ *
+ * HISTORY:
+ * render profiler -- October 2026
+ */
+
+#ifndef __BRAT_PROFILE_H__
+#define __BRAT_PROFILE_H__
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "raster.h"
+#include "tiles.h"
+
+/**
+ * Non-zero to profile. Set from the environment variable BRAT_PROFILE,
+ * and overridden on the command line by --profile.
+ */
+extern int prof_enabled;
+
+/**
+ * prof_options -- strip --profile out of argv, the same way that
+ * tile_options() does.
+ */
+void prof_options (int *argc, char *argv[]);
+
+/** The cycle counter, or nanoseconds where there isn't one. */
+static inline uint64_t prof_cycles (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * prof_iterations -- called by a callback, to report that the point
+ * it is working on took n iterations. May be called several times
+ * per point; the counts add up. Cheap enough to leave in always.
+ */
+extern thread_local long prof_iters;
+static inline void prof_iterations (long n) { prof_iters += n; }
+
+/**
+ * prof_begin -- set up the cost maps for a sizex by sizey image, and
+ * start the clock. Called by main before rendering.
+ */
+void prof_begin (int sizex, int sizey);
+
+/**
+ * prof_tile_begin, prof_tile_end -- bracket the rendering of tile t
+ * on the given thread. The tile's cycles are those in between; its
+ * calls and iterations, those charged by prof_pixel() and prof_span()
+ * on this thread in between.
+ */
+void prof_tile_begin (void);
+void prof_tile_end (const TileRect& t, int thread);
+
+/**
+ * prof_pixel -- charge one call to the callback, the given cycles,
+ * and the iterations reported since the last charge on this thread,
+ * to pixel (j, i): column j, row i, row 0 at the top.
+ */
+void prof_pixel (int i, int j, uint64_t cycles);
+
+/**
+ * prof_span -- the same, for one call that did the pixels j0..j1-1
+ * of row i all at once; the cost is shared out evenly.
+ */
+void prof_span (int i, int j0, int j1, uint64_t cycles);
+
+/**
+ * prof_report -- write the cost raster, named after path, with the
+ * viewport and run parameters in info, and print the summary.
+ */
+void prof_report (const char *path, const raster_info *info);
+
+#endif /* __BRAT_PROFILE_H__ */
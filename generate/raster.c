@@ -0,0 +1,462 @@
+/*
+ * raster.c
+ *
+ * FUNCTION:
+ * Tiled, memory-mapped raster files; the successor to .flo.
+ * See raster.h for an overview.
+ *
+ * HISTORY:
+ * tiled rasters -- October 2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "raster.h"
+
+#define RASTER_PAGE 4096
+
+_Static_assert (sizeof(raster_header) == RASTER_PAGE,
+                "raster header must be exactly one page");
+
+static uint64_t round_page (uint64_t n)
+{
+	return (n + RASTER_PAGE - 1) & ~((uint64_t) RASTER_PAGE - 1);
+}
+
+/* FNV-1a, eight bytes at a time. Not cryptographic; just enough to
+ * catch torn writes and bit-rot. */
+static uint64_t checksum (const void *buf, size_t len)
+{
+	const unsigned char *p = (const unsigned char *) buf;
+	uint64_t h = 0xcbf29ce484222325ULL;
+	size_t i = 0;
+	for (; i+8 <= len; i += 8)
+	{
+		uint64_t w;
+		memcpy (&w, p+i, 8);
+		h ^= w;
+		h *= 0x100000001b3ULL;
+	}
+	for (; i < len; i++)
+	{
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static uint64_t header_checksum (const raster_header *hdr)
+{
+	raster_header tmp = *hdr;
+	tmp.checksum = 0;
+	return checksum (&tmp, sizeof(tmp));
+}
+
+/* Byte offset of channel ch within a tile. */
+static size_t channel_offset (const raster_header *hdr, int ch)
+{
+	size_t off = 0;
+	size_t npix = (size_t) hdr->tile_width * hdr->tile_height;
+	for (int c=0; c<ch; c++) off += npix * hdr->dtype[c];
+	return off;
+}
+
+static char * tile_base (const raster *r, int tx, int ty)
+{
+	const raster_header *hdr = r->hdr;
+	size_t idx = (size_t) ty * hdr->tiles_x + tx;
+	return r->map + hdr->data_offset + idx * hdr->tile_bytes;
+}
+
+/*-------------------------------------------------------------------*/
+
+raster * raster_create (const char *path, const raster_info *info)
+{
+	if (info->nchannels < 1 || RASTER_MAX_CHANNELS < info->nchannels ||
+	    info->width < 1 || info->height < 1 ||
+	    info->tile_width < 1 || info->tile_height < 1)
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+
+	raster_header hdr;
+	memset (&hdr, 0, sizeof(hdr));
+	memcpy (hdr.magic, RASTER_MAGIC, 8);
+	hdr.header_size = sizeof(raster_header);
+	hdr.nchannels = info->nchannels;
+	hdr.width = info->width;
+	hdr.height = info->height;
+	hdr.tile_width = info->tile_width;
+	hdr.tile_height = info->tile_height;
+	hdr.tiles_x = (info->width + info->tile_width - 1) / info->tile_width;
+	hdr.tiles_y = (info->height + info->tile_height - 1) / info->tile_height;
+
+	uint64_t tb = 0;
+	for (int c=0; c<info->nchannels; c++)
+	{
+		int dt = info->dtype[c];
+		if (RASTER_FLOAT64 != dt) dt = RASTER_FLOAT32;
+		hdr.dtype[c] = dt;
+		if (info->chname[c])
+			strncpy (hdr.chname[c], info->chname[c], 15);
+		tb += (uint64_t) info->tile_width * info->tile_height * dt;
+	}
+
+	hdr.re_center = info->re_center;
+	hdr.im_center = info->im_center;
+	hdr.view_width = info->view_width;
+	hdr.view_height = info->view_height;
+	hdr.itermax = info->itermax;
+	hdr.param = info->param;
+	if (info->program)
+		strncpy (hdr.program, info->program, 63);
+
+	/* Page-align each tile, so that each can be synced on its own. */
+	uint64_t ntiles = (uint64_t) hdr.tiles_x * hdr.tiles_y;
+	hdr.tile_bytes = round_page (tb);
+	hdr.table_offset = sizeof(raster_header);
+	hdr.data_offset = round_page (hdr.table_offset +
+	                              ntiles * sizeof(raster_tile_entry));
+	hdr.checksum = header_checksum (&hdr);
+
+	size_t length = hdr.data_offset + ntiles * hdr.tile_bytes;
+
+	int fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) return NULL;
+
+	/* The file is sparse; unwritten tiles cost no disk, and read
+	 * back as zeros. */
+	if (ftruncate (fd, length))
+	{
+		int err = errno;
+		close (fd);
+		errno = err;
+		return NULL;
+	}
+
+	char *map = (char *) mmap (NULL, length, PROT_READ | PROT_WRITE,
+	                           MAP_SHARED, fd, 0);
+	if (MAP_FAILED == map)
+	{
+		int err = errno;
+		close (fd);
+		errno = err;
+		return NULL;
+	}
+
+	memcpy (map, &hdr, sizeof(hdr));
+	msync (map, RASTER_PAGE, MS_ASYNC);
+
+	raster *r = (raster *) malloc (sizeof(raster));
+	r->fd = fd;
+	r->writable = 1;
+	r->length = length;
+	r->map = map;
+	r->hdr = (raster_header *) map;
+	r->table = (raster_tile_entry *) (map + hdr.table_offset);
+	return r;
+}
+
+raster * raster_open (const char *path, int writable)
+{
+	int fd = open (path, writable ? O_RDWR : O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	if (fstat (fd, &st) || st.st_size < (off_t) sizeof(raster_header))
+	{
+		close (fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	int prot = PROT_READ;
+	if (writable) prot |= PROT_WRITE;
+	char *map = (char *) mmap (NULL, st.st_size, prot, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == map)
+	{
+		int err = errno;
+		close (fd);
+		errno = err;
+		return NULL;
+	}
+
+	raster_header *hdr = (raster_header *) map;
+	uint64_t ntiles = (uint64_t) hdr->tiles_x * hdr->tiles_y;
+	if (memcmp (hdr->magic, RASTER_MAGIC, 8) ||
+	    sizeof(raster_header) != hdr->header_size ||
+	    header_checksum (hdr) != hdr->checksum ||
+	    (uint64_t) st.st_size < hdr->data_offset + ntiles * hdr->tile_bytes)
+	{
+		munmap (map, st.st_size);
+		close (fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	raster *r = (raster *) malloc (sizeof(raster));
+	r->fd = fd;
+	r->writable = writable;
+	r->length = st.st_size;
+	r->map = map;
+	r->hdr = hdr;
+	r->table = (raster_tile_entry *) (map + hdr->table_offset);
+	return r;
+}
+
+int raster_matches (const raster *r, const raster_info *info)
+{
+	const raster_header *hdr = r->hdr;
+	if ((int) hdr->width != info->width ||
+	    (int) hdr->height != info->height ||
+	    (int) hdr->tile_width != info->tile_width ||
+	    (int) hdr->tile_height != info->tile_height ||
+	    (int) hdr->nchannels != info->nchannels)
+		return 0;
+
+	for (int c=0; c<info->nchannels; c++)
+	{
+		int dt = info->dtype[c];
+		if (RASTER_FLOAT64 != dt) dt = RASTER_FLOAT32;
+		if ((int) hdr->dtype[c] != dt) return 0;
+	}
+
+	if (hdr->re_center != info->re_center ||
+	    hdr->im_center != info->im_center ||
+	    hdr->view_width != info->view_width ||
+	    hdr->view_height != info->view_height ||
+	    hdr->itermax != info->itermax ||
+	    hdr->param != info->param)
+		return 0;
+
+	if (info->program && strncmp (hdr->program, info->program, 63))
+		return 0;
+	return 1;
+}
+
+void raster_close (raster *r)
+{
+	if (NULL == r) return;
+	if (r->writable) msync (r->map, r->length, MS_SYNC);
+	munmap (r->map, r->length);
+	close (r->fd);
+	free (r);
+}
+
+int raster_is_raster (const char *path)
+{
+	char magic[8];
+	FILE *fp = fopen (path, "rb");
+	if (NULL == fp) return 0;
+	size_t n = fread (magic, 1, 8, fp);
+	fclose (fp);
+	return (8 == n) && (0 == memcmp (magic, RASTER_MAGIC, 8));
+}
+
+/*-------------------------------------------------------------------*/
+
+void * raster_tile_data (raster *r, int tx, int ty, int ch)
+{
+	return tile_base (r, tx, ty) + channel_offset (r->hdr, ch);
+}
+
+void raster_put_rect (raster *r, int ch, int x0, int y0, int x1, int y1,
+                      const float *src, int src_stride)
+{
+	const raster_header *hdr = r->hdr;
+	int tw = hdr->tile_width;
+	int th = hdr->tile_height;
+	size_t choff = channel_offset (hdr, ch);
+	int f64 = (RASTER_FLOAT64 == hdr->dtype[ch]);
+
+	for (int y=y0; y<y1; y++)
+	{
+		const float *row = &src[(size_t) (y-y0) * src_stride];
+		int ty = y / th;
+		int ry = y % th;
+		int x = x0;
+		while (x < x1)
+		{
+			int tx = x / tw;
+			int rx = x % tw;
+			int xe = (tx+1) * tw;
+			if (x1 < xe) xe = x1;
+
+			char *base = tile_base (r, tx, ty) + choff;
+			size_t pix = (size_t) ry * tw + rx;
+			if (f64)
+			{
+				double *dst = ((double *) base) + pix;
+				for (int k=0; k<xe-x; k++) dst[k] = row[x-x0+k];
+			}
+			else
+			{
+				float *dst = ((float *) base) + pix;
+				memcpy (dst, &row[x-x0], (xe-x) * sizeof(float));
+			}
+			x = xe;
+		}
+	}
+}
+
+void raster_get_rect (const raster *r, int ch, int x0, int y0, int x1, int y1,
+                      float *dst, int dst_stride)
+{
+	const raster_header *hdr = r->hdr;
+	int tw = hdr->tile_width;
+	int th = hdr->tile_height;
+	size_t choff = channel_offset (hdr, ch);
+	int f64 = (RASTER_FLOAT64 == hdr->dtype[ch]);
+
+	for (int y=y0; y<y1; y++)
+	{
+		float *row = &dst[(size_t) (y-y0) * dst_stride];
+		int ty = y / th;
+		int ry = y % th;
+		int x = x0;
+		while (x < x1)
+		{
+			int tx = x / tw;
+			int rx = x % tw;
+			int xe = (tx+1) * tw;
+			if (x1 < xe) xe = x1;
+
+			const char *base = tile_base (r, tx, ty) + choff;
+			size_t pix = (size_t) ry * tw + rx;
+			if (f64)
+			{
+				const double *src = ((const double *) base) + pix;
+				for (int k=0; k<xe-x; k++) row[x-x0+k] = src[k];
+			}
+			else
+			{
+				const float *src = ((const float *) base) + pix;
+				memcpy (&row[x-x0], src, (xe-x) * sizeof(float));
+			}
+			x = xe;
+		}
+	}
+}
+
+void raster_tile_done (raster *r, int tx, int ty)
+{
+	const raster_header *hdr = r->hdr;
+	char *base = tile_base (r, tx, ty);
+	raster_tile_entry *ent = &r->table[(size_t) ty * hdr->tiles_x + tx];
+
+	ent->checksum = checksum (base, hdr->tile_bytes);
+	__atomic_store_n (&ent->done, 1, __ATOMIC_RELEASE);
+
+	/* Get the data on its way to disk; the table entry follows at
+	 * close, or whenever the kernel gets around to it. */
+	msync (base, hdr->tile_bytes, MS_ASYNC);
+}
+
+void raster_release_tile (raster *r, int tx, int ty)
+{
+	char *base = tile_base (r, tx, ty);
+	msync (base, r->hdr->tile_bytes, MS_SYNC);
+	madvise (base, r->hdr->tile_bytes, MADV_DONTNEED);
+}
+
+int raster_tile_is_done (const raster *r, int tx, int ty)
+{
+	const raster_tile_entry *ent = &r->table[(size_t) ty * r->hdr->tiles_x + tx];
+	return 0 != __atomic_load_n (&ent->done, __ATOMIC_ACQUIRE);
+}
+
+long raster_tiles_done (const raster *r)
+{
+	long ntiles = (long) r->hdr->tiles_x * r->hdr->tiles_y;
+	long ndone = 0;
+	for (long i=0; i<ntiles; i++)
+		if (r->table[i].done) ndone ++;
+	return ndone;
+}
+
+void raster_sync (raster *r)
+{
+	const raster_header *hdr = r->hdr;
+	uint64_t ntiles = (uint64_t) hdr->tiles_x * hdr->tiles_y;
+
+	/* Data first, then the table, so that a tile is never marked
+	 * done on disk before its data is there. */
+	msync (r->map + hdr->data_offset, ntiles * hdr->tile_bytes, MS_SYNC);
+	msync (r->map, hdr->data_offset, MS_SYNC);
+}
+
+long raster_recheck (raster *r)
+{
+	const raster_header *hdr = r->hdr;
+	long nbad = 0;
+	for (uint32_t ty=0; ty<hdr->tiles_y; ty++)
+	{
+		for (uint32_t tx=0; tx<hdr->tiles_x; tx++)
+		{
+			raster_tile_entry *ent = &r->table[ty * hdr->tiles_x + tx];
+			if (0 == ent->done) continue;
+			if (checksum (tile_base (r, tx, ty), hdr->tile_bytes) == ent->checksum)
+				continue;
+			ent->done = 0;
+			nbad ++;
+		}
+	}
+	return nbad;
+}
+
+long raster_verify (const raster *r)
+{
+	const raster_header *hdr = r->hdr;
+	long nbad = 0;
+	for (uint32_t ty=0; ty<hdr->tiles_y; ty++)
+	{
+		for (uint32_t tx=0; tx<hdr->tiles_x; tx++)
+		{
+			const raster_tile_entry *ent = &r->table[ty * hdr->tiles_x + tx];
+			if (0 == ent->done) continue;
+			if (checksum (tile_base (r, tx, ty), hdr->tile_bytes) != ent->checksum)
+				nbad ++;
+		}
+	}
+	return nbad;
+}
+
+void raster_get_row (const raster *r, int ch, int y, float *out)
+{
+	const raster_header *hdr = r->hdr;
+	int tw = hdr->tile_width;
+	int th = hdr->tile_height;
+	size_t choff = channel_offset (hdr, ch);
+	int f64 = (RASTER_FLOAT64 == hdr->dtype[ch]);
+	int ty = y / th;
+	int ry = y % th;
+
+	for (uint32_t tx=0; tx<hdr->tiles_x; tx++)
+	{
+		int x0 = tx * tw;
+		int n = hdr->width - x0;
+		if (tw < n) n = tw;
+
+		const char *base = tile_base (r, tx, ty) + choff;
+		size_t pix = (size_t) ry * tw;
+		if (f64)
+		{
+			const double *src = ((const double *) base) + pix;
+			for (int k=0; k<n; k++) out[x0+k] = src[k];
+		}
+		else
+		{
+			memcpy (&out[x0], ((const float *) base) + pix, n * sizeof(float));
+		}
+	}
+}
+
+/* --------------------------- END OF LIFE ------------------------- */
@@ -0,0 +1,222 @@
+/*
+ * raster.h
+ *
+ * FUNCTION:
+ * Tiled, memory-mapped raster files; the successor to .flo.
+ *
+ * A .flo file is a "width height\n" line followed by raw floats, with
+ * the run parameters in a separate .txt file. That has to be written
+ * in one go, from an image that fits in RAM. A raster file instead
+ * holds a fixed-size header with the image size, the viewport, the
+ * iteration count and the param, followed by a table of tiles, and
+ * then the tiles themselves. The file is created at full size up
+ * front, and mmap'ed; tiles can be written in any order, as they are
+ * finished, and each one is checksummed and marked done when it is
+ * complete. A file with some tiles still missing is a partial render,
+ * and can be recognized as such.
+ *
+ * Each pixel may hold several channels, each either float32 or
+ * float64. Within a tile, the channels are stored one after another,
+ * each as a tile_width x tile_height block in row-major order. Edge
+ * tiles are stored at full size, and padded with zeros.
+ *
+ * Readers map the file, and get pointers straight into the mapping;
+ * nothing is copied.
+ *
+ * HISTORY:
+ * tiled rasters -- October 2026
+ */
+
+#ifndef __BRAT_RASTER_H__
+#define __BRAT_RASTER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define RASTER_MAGIC "BRATRST1"
+#define RASTER_MAX_CHANNELS 8
+#define RASTER_FLOAT32 4
+#define RASTER_FLOAT64 8
+
+/**
+ * On-disk header. Fixed size, padded out to one page, so that the
+ * tiles that follow are page-aligned. All fields are little-endian,
+ * i.e. native, on every machine this is likely to run on.
+ */
+typedef struct
+{
+	char     magic[8];        /* RASTER_MAGIC */
+	uint32_t header_size;     /* sizeof(raster_header) */
+	uint32_t nchannels;
+	uint32_t width;           /* image size, in pixels */
+	uint32_t height;
+	uint32_t tile_width;
+	uint32_t tile_height;
+	uint32_t tiles_x;         /* number of tiles across */
+	uint32_t tiles_y;         /* number of tiles down */
+	uint32_t dtype[RASTER_MAX_CHANNELS];   /* RASTER_FLOAT32 or 64 */
+	char     chname[RASTER_MAX_CHANNELS][16];
+
+	/* viewport and run parameters, as given on the command line */
+	double   re_center;
+	double   im_center;
+	double   view_width;
+	double   view_height;
+	int64_t  itermax;
+	double   param;
+	char     program[64];
+
+	uint64_t tile_bytes;      /* bytes per tile, all channels */
+	uint64_t table_offset;    /* file offset of the tile table */
+	uint64_t data_offset;     /* file offset of the first tile */
+	uint64_t checksum;        /* of the header, with this set to 0 */
+	char     pad[3752];
+} raster_header;
+
+/** One entry in the tile table. */
+typedef struct
+{
+	uint64_t checksum;        /* of the tile data, once done */
+	uint32_t done;            /* zero until the tile is written */
+	uint32_t pad;
+} raster_tile_entry;
+
+/** Parameters for raster_create() */
+typedef struct
+{
+	int width;
+	int height;
+	int tile_width;
+	int tile_height;
+	int nchannels;
+	int dtype[RASTER_MAX_CHANNELS];
+	const char *chname[RASTER_MAX_CHANNELS];
+
+	double re_center;
+	double im_center;
+	double view_width;
+	double view_height;
+	long itermax;
+	double param;
+	const char *program;
+} raster_info;
+
+typedef struct
+{
+	int fd;
+	int writable;
+	size_t length;
+	char *map;
+	raster_header *hdr;
+	raster_tile_entry *table;
+} raster;
+
+/**
+ * raster_create -- create a new raster file, at full size, and map it.
+ * Channels that don't have a dtype set default to float32. Returns
+ * NULL, with errno set, on failure.
+ */
+raster * raster_create (const char *path, const raster_info *info);
+
+/**
+ * raster_open -- map an existing raster file, read-only unless
+ * writable is set. Returns NULL if the file can't be mapped, or if
+ * the header is corrupt.
+ */
+raster * raster_open (const char *path, int writable);
+
+/**
+ * raster_matches -- return true if the raster was made with the same
+ * image size, tile size, channels, viewport and run parameters as
+ * those in info. Used to check that a partial render can be resumed.
+ */
+int raster_matches (const raster *r, const raster_info *info);
+
+/** Unmap and close. Written tiles are flushed to disk first. */
+void raster_close (raster *r);
+
+/** Return true if the file starts with the raster magic. */
+int raster_is_raster (const char *path);
+
+/**
+ * raster_tile_data -- pointer to the data for channel ch of tile
+ * (tx, ty), in the mapping. The block is tile_width x tile_height,
+ * row-major, of the channel's dtype.
+ */
+void * raster_tile_data (raster *r, int tx, int ty, int ch);
+
+/**
+ * raster_put_rect -- copy a rectangle of floats into channel ch,
+ * converting to the channel's dtype. The rectangle [x0,x1) x [y0,y1)
+ * may span several tiles. src holds the rectangle's pixels in rows
+ * of src_stride floats.
+ */
+void raster_put_rect (raster *r, int ch, int x0, int y0, int x1, int y1,
+                      const float *src, int src_stride);
+
+/**
+ * raster_get_rect -- the inverse of raster_put_rect(): copy the
+ * rectangle [x0,x1) x [y0,y1) of channel ch out into dst, as floats,
+ * in rows of dst_stride floats.
+ */
+void raster_get_rect (const raster *r, int ch, int x0, int y0, int x1, int y1,
+                      float *dst, int dst_stride);
+
+/**
+ * raster_tile_done -- checksum tile (tx, ty), mark it as done, and
+ * schedule it to be written out. Call once all of its channels are
+ * filled in.
+ */
+void raster_tile_done (raster *r, int tx, int ty);
+
+/**
+ * raster_release_tile -- write tile (tx, ty) out to disk now, and
+ * drop it from memory. For streaming writers, so that the page cache
+ * doesn't fill up with tiles that won't be touched again.
+ */
+void raster_release_tile (raster *r, int tx, int ty);
+
+/** Return true if tile (tx, ty) has been marked done. */
+int raster_tile_is_done (const raster *r, int tx, int ty);
+
+/** Number of tiles that are done. */
+long raster_tiles_done (const raster *r);
+
+/**
+ * raster_sync -- flush all of the tiles marked done so far, and then
+ * the tile table, to disk, waiting until they are written. After a
+ * crash, the file holds at least the tiles that were done at the
+ * last sync. Checkpoints call this every so often.
+ */
+void raster_sync (raster *r);
+
+/**
+ * raster_recheck -- recompute the checksum of every done tile, and
+ * clear the done flag of any that don't match, e.g. tiles whose table
+ * entry reached the disk before the data did. Returns the number of
+ * tiles cleared. Call this before resuming a partial render.
+ */
+long raster_recheck (raster *r);
+
+/**
+ * raster_verify -- recompute the checksum of every done tile.
+ * Returns the number of bad tiles.
+ */
+long raster_verify (const raster *r);
+
+/**
+ * raster_get_row -- copy row y of channel ch into out[], as floats.
+ * Convenience for readers that want whole scanlines; missing tiles
+ * read as zero.
+ */
+void raster_get_row (const raster *r, int ch, int y, float *out);
+
+#ifdef  __cplusplus
+};
+#endif
+
+#endif /* __BRAT_RASTER_H__ */
@@ -0,0 +1,101 @@
+/*
+ * regulated.h
+ *
+ * FUNCTION:
+ * Regulated orbit sums for the spectral renders of cutoff.C.
+ *
+ * The spectral renders sum things like z_n, z'_n and z''_n (the
+ * derivatives are with respect to c) over the orbit of c, with each
+ * term weighted by a regulator exp(-n^2 tau^2) that cuts the sum off
+ * smoothly. The first and second derivatives of the regulator with
+ * respect to tau give the sums needed to extrapolate to tau=0 with a
+ * Taylor expansion.
+ *
+ * The regulator and its derivatives depend only on itermax and tau,
+ * and so are tabulated once, and kept for as long as the program
+ * runs, so that a series of frames with the same itermax shares one
+ * set of tables.
+ *
+ * The sums themselves are done REG_LANES pixels at once, in lock-step,
+ * each lane masked off as its orbit escapes. Each lane does the same
+ * arithmetic, in the same order, as the scalar loop that this came
+ * from, so the sums are bit-identical to it. Only the sums that are
+ * asked for are done.
+ *
+ * HISTORY:
+ * regulated sums -- October 2026
+ */
+
+#ifndef __BRAT_REGULATED_H__
+#define __BRAT_REGULATED_H__
+
+#include <vector>
+
+/**
+ * Number of pixels handled at once. The sums take up many registers;
+ * without AVX, gcc splits four-wide vectors into pairs and keeps them
+ * on the stack, which is slower than plain scalar code. So two lanes,
+ * one SSE2 register, unless compiled with -mavx or better.
+ */
+#ifndef REG_LANES
+#ifdef __AVX__
+#define REG_LANES 4
+#else
+#define REG_LANES 2
+#endif
+#endif
+
+/**
+ * RegTable -- the regulator exp(-n^2 tau^2), for n from 0 to
+ * itermax-1, its first and second derivatives with respect to tau,
+ * and their sums over n.
+ */
+struct RegTable
+{
+	int itermax;
+	double tau;
+	std::vector<double> r, rp, rpp;
+	double sum_n, sum_np, sum_npp;
+};
+
+/**
+ * reg_table -- the tables for itermax and tau; made on the first
+ * call, and looked up after that. Safe to call from any thread.
+ */
+const RegTable& reg_table (int itermax, double tau);
+
+/**
+ * RegSums -- the regulated sums over the orbit of one point.
+ * The suffixes p and pp mark the sums weighted by the first and
+ * second derivatives of the regulator, instead of by the regulator.
+ */
+struct RegSums
+{
+	/* z */
+	double re, im, rep, imp, repp, impp;
+	/* z' */
+	double dre, dim;
+	/* z'' */
+	double ddre, ddim, ddrep, ddimp, ddrepp, ddimpp;
+	/* z'/z and z''/z */
+	double zpre, zpim, zppre, zppim;
+};
+
+/* Which of the sums to do; or-ed together. */
+#define REG_Z     0x1    /* re, im and their p, pp */
+#define REG_DZ    0x2    /* dre, dim */
+#define REG_DDZ   0x4    /* ddre, ddim and their p, pp */
+#define REG_ZP    0x8    /* zpre, zpim, zppre, zppim */
+
+/**
+ * reg_orbit_sums -- the regulated sums for the npts points c. Each
+ * orbit starts at z = c, z' = 1, z'' = 0; for n = 1, 2, ... itermax-1,
+ * the terms for z_n are added in, and then z is iterated; the orbit
+ * stops once |z|^2 > esq. Only the sums in need are done; the others
+ * are left at zero.
+ */
+void reg_orbit_sums (int npts, const double *re_c, const double *im_c,
+                     double esq, const RegTable& tab, int need,
+                     RegSums *sums);
+
+#endif /* __BRAT_REGULATED_H__ */
@@ -0,0 +1,73 @@
+/*
+ * series.h
+ *
+ * FUNCTION:
+ * Precomputed coefficient tables for q-series and generating
+ * functions, and a vectorized kernel for summing a power series
+ * at several pixels at once.
+ *
+ * The disk renders sum a_n q^n for 10^5 or more terms at every pixel;
+ * computing a_n = phi(n), mu(n), d(n) etc. afresh for each term at
+ * each pixel is far more expensive than the series itself. The tables
+ * here are built once, with a sieve where possible, and then shared,
+ * read-only, by all of the rendering threads.
+ *
+ * HISTORY:
+ * coefficient tables -- October 2026
+ */
+
+#ifndef __BRAT_SERIES_H__
+#define __BRAT_SERIES_H__
+
+/**
+ * Tables of arithmetic functions: the returned array a[] holds
+ * a[n] for 0 <= n <= nmax, with a[0] set to zero. These are filled
+ * with a linear sieve, in O(nmax) time. The tables are cached, and
+ * are never freed; the same pointer is returned on each call (until
+ * a bigger nmax is asked for). Safe to call from any thread.
+ */
+const double * totient_table (long nmax);
+const double * moebius_table (long nmax);
+const double * divisor_table (long nmax);
+
+/**
+ * Generic tables: a[n] = func(n) for 1 <= n <= nmax, and a[0] = 0.
+ * Each func(n) is evaluated exactly once, no matter how many pixels
+ * or threads use the table. Cached by function pointer.
+ */
+typedef long SeriesIntFn (long n);
+typedef double SeriesRealFn (long n);
+const double * series_table (SeriesIntFn *func, long nmax);
+const double * series_table (SeriesRealFn *func, long nmax);
+
+/**
+ * Number of pixels handled at once by series_sum_lanes(). Four
+ * doubles fill an AVX2 register, eight fill an AVX-512 register;
+ * compile with -mavx2 or -mavx512f to get the wide instructions.
+ */
+#ifndef SERIES_LANES
+#define SERIES_LANES 4
+#endif
+
+/**
+ * series_sum_lanes -- sum_{i=0}^{nterms-1} coeff[i] q^i for
+ * SERIES_LANES values of q at once.
+ *
+ * Each lane stops accumulating as soon as |q^i|^2 drops below
+ * 1.0e-30, exactly as the scalar loops do, and lanes with |q|>=1
+ * return zero. The summation order is the same as the scalar loop,
+ * so the results are bit-identical to it.
+ */
+void series_sum_lanes (const double *coeff, long nterms,
+                       const double *re_q, const double *im_q,
+                       double *re_sum, double *im_sum);
+
+/**
+ * series_sum -- same as above, for an arbitrary number of points.
+ * The points are processed SERIES_LANES at a time.
+ */
+void series_sum (const double *coeff, long nterms, int npts,
+                 const double *re_q, const double *im_q,
+                 double *re_sum, double *im_sum);
+
+#endif /* __BRAT_SERIES_H__ */
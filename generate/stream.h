@@ -0,0 +1,59 @@
+/*
+ * stream.h
+ *
+ * FUNCTION:
+ * Out-of-core rendering, one band of rows at a time.
+ *
+ * Normally, the whole image is rendered into one big array, which is
+ * written out at the end. At 64k x 64k that is 16 GiB of floats. In
+ * streaming mode, the image is instead rendered a band of rows at a
+ * time; each finished band is handed to a writer thread, through a
+ * bounded queue, while the next band is being rendered. Peak memory
+ * is then a few bands, no matter how big the image is.
+ *
+ * HISTORY:
+ * streaming bands -- October 2026
+ */
+
+#ifndef __BRAT_STREAM_H__
+#define __BRAT_STREAM_H__
+
+#include <functional>
+
+/**
+ * Number of rows per band, in streaming mode; zero if not streaming.
+ * Set from the environment variable BRAT_STREAM, and overridden on
+ * the command line by --stream (default band height) or
+ * --stream=<nrows>. stream_depth is the number of band buffers; at
+ * most that many bands are in memory at once.
+ */
+extern int stream_rows;
+extern int stream_depth;
+
+/**
+ * stream_options -- strip streaming options out of argv, the same
+ * way that tile_options() does.
+ */
+void stream_options (int *argc, char *argv[]);
+
+/**
+ * StreamBandFn -- callback for one band. rows[] holds rows y0 up
+ * to (but not including) y1, each of sizex floats, so that pixel
+ * (x, y) is at rows[(y-y0)*sizex + x].
+ */
+typedef std::function<void (float *rows, int y0, int y1)> StreamBandFn;
+
+/**
+ * RunStream -- render a sizex by sizey image in bands of nrows rows.
+ *
+ * render() is called for each band in turn, top to bottom, on the
+ * calling thread; it is handed a zeroed band to fill in, and may use
+ * RunTiles() or RunBands() to spread the work over many threads.
+ * write() is called for each finished band, in the same order, on a
+ * separate writer thread. At most stream_depth bands are allocated;
+ * render() waits for the writer if it falls behind.
+ */
+void RunStream (int sizex, int sizey, int nrows,
+                StreamBandFn render, StreamBandFn write);
+
+#endif /* __BRAT_STREAM_H__ */
@@ -0,0 +1,75 @@
+/*
+ * supersample.h
+ *
+ * FUNCTION:
+ * Adaptive supersampling for the brat.h height maps.
+ *
+ * Normally, the height callback is evaluated once per pixel. To get
+ * an anti-aliased image, one could render at 4x or 16x the size and
+ * shrink it, but that costs 4x or 16x everywhere, even where the
+ * image is smooth. Instead, each tile is first rendered with one
+ * sample per pixel; pixels that differ sharply from a neighbor are
+ * then re-sampled on a 2x2 grid, and those whose samples still
+ * disagree on a 4x4 grid, and so on, up to the sample budget. The
+ * pixel is the average of its samples. Smooth regions cost the same
+ * as before.
+ *
+ * HISTORY:
+ * adaptive supersampling -- October 2026
+ */
+
+#ifndef __BRAT_SUPERSAMPLE_H__
+#define __BRAT_SUPERSAMPLE_H__
+
+#include <functional>
+
+#include "tiles.h"
+
+/**
+ * Maximum number of samples per pixel; 1 (the default) turns the
+ * supersampling off. Rounded down to a power of four. Set from the
+ * environment variable BRAT_AA, and overridden on the command line
+ * by --aa (16 samples) or --aa=<spp>.
+ *
+ * A pixel is refined when the contrast between it and a neighbor,
+ * or between any two of its samples, is large: when
+ * |a-b| > aa_threshold * (|a|+|b|) + aa_floor. aa_threshold is set
+ * from BRAT_AA_THRESHOLD, and overridden by --aa-threshold=<t>; the
+ * default is 0.02. aa_floor is set from BRAT_AA_FLOOR, and overridden
+ * by --aa-floor=<f>; the default is 1e-3, well under one grey level
+ * of an 8-bit image of heights in [0,1].
+ */
+extern int aa_max_spp;
+extern double aa_threshold;
+extern double aa_floor;
+
+/**
+ * aa_options -- strip supersampling options out of argv, the same
+ * way that tile_options() does.
+ */
+void aa_options (int *argc, char *argv[]);
+
+/** SampleFn -- the height at the point (x, y) of the plane. */
+typedef std::function<double (double x, double y)> SampleFn;
+
+/**
+ * SupersampleTile -- render tile t, adaptively.
+ *
+ * Pixel (i, j) has its first sample at x = re_start + j*delta,
+ * y = im_start - i*delta, and covers the square of side delta
+ * centered on that. The result for pixel (i, j) goes into
+ * glob[(i-row0)*sizex + j]. May be called from many threads at once.
+ */
+void SupersampleTile (float *glob, int row0, const TileRect& t, int sizex,
+                      double re_start, double im_start, double delta,
+                      SampleFn sample);
+
+/**
+ * aa_reset, aa_report -- clear, and print to stderr, the histogram
+ * of the number of samples taken per pixel, over all tiles rendered
+ * since the last reset.
+ */
+void aa_reset (void);
+void aa_report (void);
+
+#endif /* __BRAT_SUPERSAMPLE_H__ */
@@ -0,0 +1,131 @@
+/*
+ * tiles.h
+ *
+ * FUNCTION:
+ * Work-stealing tile scheduler for the brat.h renderers.
+ *
+ * The image is chopped into small square tiles, and the tiles are
+ * dealt out round-robin onto per-thread work queues. Each thread
+ * works from the front of its own queue; when that runs dry, it
+ * steals from the back of some other thread's queue. This keeps all
+ * cores busy even when the cost-per-pixel varies by orders of
+ * magnitude across the image (e.g. q-series near |q|=1).
+ *
+ * HISTORY:
+ * work-stealing tiles -- October 2026
+ */
+
+#ifndef __BRAT_TILES_H__
+#define __BRAT_TILES_H__
+
+#include <functional>
+
+/**
+ * TileRect -- a rectangle of pixels, half-open: [x0,x1) x [y0,y1).
+ * Row y=0 is the top of the image.
+ */
+struct TileRect
+{
+	int x0, y0;
+	int x1, y1;
+};
+
+/**
+ * TileWorkFn -- callback that renders one tile.
+ * The thread argument is the index of the worker thread,
+ * in the range 0 to tile_num_threads()-1.
+ */
+typedef std::function<void (const TileRect&, int thread)> TileWorkFn;
+
+/**
+ * Number of worker threads, and the edge-length of the tiles, in
+ * pixels. These are set from the environment variables BRAT_THREADS
+ * and BRAT_TILE, and can be overridden on the command line with the
+ * -j <nthreads> and -t <tilesize> flags (see tile_options()).
+ * A thread count of zero means "use all available cores".
+ */
+extern int tile_nthreads;
+extern int tile_size;
+
+/**
+ * If non-zero (the default), RunTiles() and RunBands() print their
+ * progress, and per-thread statistics, to stderr. Callers that run
+ * many small images in a row (e.g. streaming bands) turn it off.
+ */
+extern int tile_verbose;
+
+/**
+ * env_int, env_long, env_double -- the value of the environment
+ * variable name, or dflt if it is unset or empty. The option globals
+ * of tiles, stream, supersample etc. take their defaults from these.
+ */
+int env_int (const char *name, int dflt);
+long env_long (const char *name, long dflt);
+double env_double (const char *name, double dflt);
+
+/**
+ * OptionFn -- looks at one argument, arg, with next the argument after
+ * it (NULL if there is none). Returns how many arguments it used up:
+ * 0 if arg is not one of its options, 1 for arg alone, 2 for arg and
+ * next.
+ */
+typedef std::function<int (char *arg, char *next)> OptionFn;
+
+/**
+ * strip_options -- hand each of argv[1], argv[2] ... to fn, and remove
+ * the arguments that it uses up from argv, decrementing argc to match,
+ * so that the remaining positional arguments can be parsed as before.
+ * All of the *_options() functions are built on this.
+ */
+void strip_options (int *argc, char *argv[], OptionFn fn);
+
+/**
+ * strip_flag -- remove flag, such as --raster, from argv; returns
+ * true if it was there.
+ */
+bool strip_flag (int *argc, char *argv[], const char *flag);
+
+/**
+ * tile_options -- strip scheduler options out of argv.
+ *
+ * Recognizes "-j N", "--threads=N", "-t N" and "--tile=N", removes
+ * them from argv, and decrements argc accordingly, so that the
+ * remaining positional arguments can be parsed as before.
+ */
+void tile_options (int *argc, char *argv[]);
+
+/**
+ * tile_thread_hooks -- per-thread setup and teardown.
+ *
+ * The init hook is called once in each worker thread, before that
+ * thread renders any tiles; the fini hook is called once in each
+ * worker thread, after all tiles are done. The hooks are called one
+ * thread at a time, and all init hooks finish before the first tile
+ * is rendered, so they may safely touch global state (such as the
+ * GMP default precision). Either hook may be empty. The hooks stay
+ * in effect until replaced.
+ */
+typedef std::function<void (void)> TileThreadFn;
+void tile_thread_hooks (TileThreadFn init, TileThreadFn fini);
+
+/** Number of threads that RunTiles() will actually use. */
+int tile_num_threads (void);
+
+/**
+ * RunTiles -- render a sizex by sizey image, one tile at a time.
+ *
+ * Calls fn once for every tile covering the image, spreading the
+ * calls over tile_num_threads() threads. Returns after all tiles
+ * are done. Per-thread busy/idle times are printed to stderr.
+ */
+void RunTiles (int sizex, int sizey, TileWorkFn fn);
+
+/**
+ * RunBands -- like RunTiles, but the tiles are horizontal bands that
+ * span the full width of the image, and are nrows tall. Useful for
+ * callbacks that can only work on whole rows, such as bifurcation
+ * diagrams.
+ */
+void RunBands (int sizex, int sizey, int nrows, TileWorkFn fn);
+
+#endif /* __BRAT_TILES_H__ */
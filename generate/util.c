@@ -20,7 +20,7 @@
  */
 
 int
-Open(char *name, char *ext)
+Open(const char *name, const char *ext)
 {
     int fd;
 
@@ -53,7 +53,7 @@ Open(char *name, char *ext)
  * name==0 => stdin
  */
 
-FILE *Fopen(char *name, char *ext)
+FILE *Fopen(const char *name, const char *ext)
 {
     FILE *fyle;
 
@@ -85,7 +85,7 @@ FILE *Fopen(char *name, char *ext)
  * name==0 => stdin
  */
 
-FILE *Fopenr(char *name, char *ext)
+FILE *Fopenr(const char *name, const char *ext)
 {
     FILE *fyle;
 
@@ -6,12 +6,15 @@
  * HISTORY:
  * Linas Vepstas January 16 1994
  * Fix colormap 16 Dec 2017
+ * Read tiled raster files October 2026
  */
 
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "raster.h"
+
 struct rgb {
    char r;
    char g;
@@ -61,6 +64,71 @@ void make_cmap (void)
 
 /* ------------------------------------------------------------ */
 
+static void color_pixel (char *out, float val)
+{
+   int k;
+
+   /* make sure large overflows don't wrap the integers */
+   if (0.0 > val) val = 0.0;
+   if (1.0 < val) val = 1.0;
+   k = (int) (239.5 * val);
+
+   if (k<0) k=0;
+   if (k>239) k=239;
+
+   out[0] = vlt[k].r;
+   out[1] = vlt[k].g;
+   out[2] = vlt[k].b;
+}
+
+/* Tiled raster files are mapped, and read straight out of the
+ * mapping, one tile-row at a time. */
+static int raster_to_mtv (const char *path)
+{
+   raster *r = raster_open (path, 0);
+   if (NULL == r) {
+      fprintf (stderr, "Can't open raster file %s\n", path);
+      return 1;
+   }
+   const raster_header *hdr = r->hdr;
+   int width = hdr->width;
+   int height = hdr->height;
+   int tw = hdr->tile_width;
+   int th = hdr->tile_height;
+   int f64 = (RASTER_FLOAT64 == hdr->dtype[0]);
+
+   if (raster_tiles_done (r) < (long) hdr->tiles_x * hdr->tiles_y)
+      fprintf (stderr, "Warning: %s is a partial render\n", path);
+
+   fprintf (stdout, "%d %d\n", width, height);
+
+   char *out_row = (char *) malloc (3*width*sizeof (char));
+   for (int i=0; i<height; i++) {
+      int ty = i / th;
+      int ry = i % th;
+      for (int tx=0; tx < (int) hdr->tiles_x; tx++) {
+         int x0 = tx * tw;
+         int n = width - x0;
+         if (tw < n) n = tw;
+         void *tile = raster_tile_data (r, tx, ty, 0);
+         for (int j=0; j<n; j++) {
+            float val;
+            if (f64) val = ((double *) tile)[ry*tw + j];
+            else val = ((float *) tile)[ry*tw + j];
+            color_pixel (&out_row[3*(x0+j)], val);
+         }
+      }
+      fwrite (out_row, 3*sizeof(char), width, stdout);
+   }
+   fflush (stdout);
+
+   free (out_row);
+   raster_close (r);
+   return 0;
+}
+
+/* ------------------------------------------------------------ */
+
 int main (int argc, char* argv[])
 {
    FILE *fil;
@@ -76,6 +144,9 @@ int main (int argc, char* argv[])
 
    make_cmap ();
 
+   if (argc == 2 && raster_is_raster (argv[1]))
+      return raster_to_mtv (argv[1]);
+
    /* open up the file */
    if (argc == 2) {
       fil = fopen (argv[1], "r");
@@ -107,19 +178,7 @@ int main (int argc, char* argv[])
    for (i=0; i<height; i++) {
       fread (in_row, sizeof(float), width, fil);
       for (j=0; j<width; j++) {
-         int k;
-
-         /* make sure large overflows don't wrap the integers */
-         if (0.0 > in_row[j]) in_row[j] = 0.0;
-         if (1.0 < in_row[j]) in_row[j] = 1.0;
-         k = (int) (239.5 * in_row[j]);
-
-         if (k<0) k=0;
-         if (k>239) k=239;
-
-         out_row[3*j] = vlt[k].r;
-         out_row[3*j+1] = vlt[k].g;
-         out_row[3*j+2] = vlt[k].b;
+         color_pixel (&out_row[3*j], in_row[j]);
       }
       fwrite (out_row, 3*sizeof(char), width, stdout);
       fflush (stdout);
@@ -127,6 +186,7 @@ int main (int argc, char* argv[])
 
    free (in_row);
    free (out_row);
+   return 0;
 }
 
 /* ---------------------- END OF FILE ------------------------- */
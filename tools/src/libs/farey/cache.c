@@ -1,19 +1,70 @@
 /**
  * cache.c
  * Generic cache management for frequently requested numbers.
- * Includes thread-safe locks. Locks are implemented as spinlocks,
- * these seem to be the best deal for the current CPU --
- * pthread_mutex_t is slow, and pthread_rwlock_t is even slower(!)
+ *
+ * These used to take a spinlock on every check, fetch and store, and
+ * realloc the array on growth, which moved it out from under any
+ * concurrent readers. Under the threaded renderers, most of the time
+ * went into contending for the spinlock. Now the cache is a fixed
+ * directory of chunks, each twice the size of the one before; chunks
+ * are never moved or freed, and each entry carries a state byte that
+ * is published atomically. Reads take no locks at all.
  *
  * Linas Vepstas 2005, 2006, 2016
+ * Lock-free rewrite October 2026
  */
 
 #include <stdlib.h>
 
 #include "cache.h"
 
+/* Entry states. An entry goes EMPTY -> BUSY -> READY; the writer
+ * that wins the EMPTY -> BUSY transition is the only one to write
+ * the value, and readers only look at the value once it is READY. */
+#define CACHE_EMPTY 0
+#define CACHE_BUSY  1
+#define CACHE_READY 2
+
+/* Locate index n: chunk k holds indexes CACHE_CHUNK*(2^k - 1) up to
+ * CACHE_CHUNK*(2^(k+1) - 1). Returns false if n is out of range. */
+static inline bool cache_locate(unsigned __int128 n, int *k,
+                                unsigned long *off, unsigned long *size)
+{
+	unsigned __int128 q = n / CACHE_CHUNK + 1;
+	if (q >> CACHE_NCHUNKS) return false;
+	*k = 63 - __builtin_clzl((unsigned long) q);
+	*size = ((unsigned long) CACHE_CHUNK) << *k;
+	*off = (unsigned long) n - (*size - CACHE_CHUNK);
+	return true;
+}
+
+/* The state bytes live right after the values, in the same block. */
+#define CACHE_STATE(chunk,size) ((unsigned char *) &(chunk)[size])
+
 /* =============================================================== */
-/** TYPE_NAME##_d_cache_check() -- check if value is in the cache
+/**
+ * TYPE_NAME##_get_chunk - return chunk k, allocating it if needed.
+ * Racing allocators are resolved with a compare-and-swap; the loser
+ * frees its copy and uses the winner's.
+ */
+#define CACHE_GET_CHUNK(TYPE_NAME,TYPE,IDX_TYPE) \
+static TYPE * TYPE_NAME##_get_chunk(TYPE_NAME##_cache *c, int k,	\
+                                    unsigned long size)	\
+{	\
+	TYPE *chunk = __atomic_load_n(&c->chunk[k], __ATOMIC_ACQUIRE);	\
+	if (chunk) return chunk;	\
+	\
+	TYPE *fresh = (TYPE *) calloc (size, sizeof(TYPE) + 1);	\
+	TYPE *expect = NULL;	\
+	if (__atomic_compare_exchange_n(&c->chunk[k], &expect, fresh,	\
+	          false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))	\
+		return fresh;	\
+	free (fresh);	\
+	return expect;	\
+}
+
+/**
+ * TYPE_NAME##_d_cache_check() -- check if value is in the cache
  *  Returns true if the value is in the cache, else returns false.
  *  This assumes a 1-dimensional cache layout (simple aray)
  */
@@ -21,42 +72,30 @@
 bool TYPE_NAME##_one_d_cache_check(TYPE_NAME##_cache *c, IDX_TYPE n)	\
 {	\
 	if (c->disabled) return false;	\
-	pthread_spin_lock(&c->spin);	\
-	if ((n > c->nmax) || 0==n )	\
-	{	\
-		IDX_TYPE newsize = 1.5*n+100;	\
-		c->cache = (TYPE *) realloc (c->cache, newsize * sizeof (TYPE));	\
-		c->ticky = (bool *) realloc (c->ticky, newsize * sizeof (bool));	\
-		\
-		IDX_TYPE en;	\
-		IDX_TYPE nstart = c->nmax+1;	\
-		if (0 == c->nmax) nstart = 0;	\
-		for (en=nstart; en <newsize; en++)	\
-		{	\
-			c->cache[en] = (TYPE) 0;	\
-			c->ticky[en] = false;	\
-		}	\
-		c->nmax = newsize-1;	\
-		pthread_spin_unlock(&c->spin);	\
-		return false;	\
-	}	\
-	\
-	bool haveit = c->ticky[n];	\
-	pthread_spin_unlock(&c->spin);	\
-	return haveit;	\
+	int k; unsigned long off, size;	\
+	if (!cache_locate(n, &k, &off, &size)) return false;	\
+	TYPE *chunk = __atomic_load_n(&c->chunk[k], __ATOMIC_ACQUIRE);	\
+	if (NULL == chunk) return false;	\
+	unsigned char *state = CACHE_STATE(chunk, size);	\
+	return CACHE_READY == __atomic_load_n(&state[off], __ATOMIC_ACQUIRE);	\
 }
 
 /**
  * TYPE_NAME##_d_cache_fetch - fetch value from cache
+ * Returns zero if the value is not in the cache.
  */
 #define CACHE_FETCH(TYPE_NAME,TYPE,IDX_TYPE) \
 TYPE TYPE_NAME##_one_d_cache_fetch(TYPE_NAME##_cache *c, IDX_TYPE n)	\
 {	\
 	if (c->disabled) return (TYPE) 0;	\
-	pthread_spin_lock(&c->spin);	\
-	TYPE val = c->cache[n];	\
-	pthread_spin_unlock(&c->spin);	\
-	return val;	\
+	int k; unsigned long off, size;	\
+	if (!cache_locate(n, &k, &off, &size)) return (TYPE) 0;	\
+	TYPE *chunk = __atomic_load_n(&c->chunk[k], __ATOMIC_ACQUIRE);	\
+	if (NULL == chunk) return (TYPE) 0;	\
+	unsigned char *state = CACHE_STATE(chunk, size);	\
+	if (CACHE_READY != __atomic_load_n(&state[off], __ATOMIC_ACQUIRE))	\
+		return (TYPE) 0;	\
+	return chunk[off];	\
 }
 
 /**
@@ -66,35 +105,74 @@ TYPE TYPE_NAME##_one_d_cache_fetch(TYPE_NAME##_cache *c, IDX_TYPE n)	\
 void TYPE_NAME##_one_d_cache_store(TYPE_NAME##_cache *c, TYPE val, IDX_TYPE n)	\
 {	\
 	if (c->disabled) return;	\
-	pthread_spin_lock(&c->spin);	\
-	c->cache[n] = val;	\
-	c->ticky[n] = true;	\
-	pthread_spin_unlock(&c->spin);	\
+	int k; unsigned long off, size;	\
+	if (!cache_locate(n, &k, &off, &size)) return;	\
+	TYPE *chunk = TYPE_NAME##_get_chunk(c, k, size);	\
+	unsigned char *state = CACHE_STATE(chunk, size);	\
+	unsigned char expect = CACHE_EMPTY;	\
+	if (!__atomic_compare_exchange_n(&state[off], &expect, CACHE_BUSY,	\
+	          false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))	\
+		return;	\
+	chunk[off] = val;	\
+	__atomic_store_n(&state[off], CACHE_READY, __ATOMIC_RELEASE);	\
 }
 
 /**
  * TYPE_NAME##_d_cache_clear - clear the cache
+ * The chunks are kept; only the entries are marked empty. Not safe
+ * to run concurrently with store().
  */
 #define CACHE_CLEAR(TYPE_NAME,TYPE,IDX_TYPE) \
 void TYPE_NAME##_one_d_cache_clear(TYPE_NAME##_cache *c)	\
 {	\
-	IDX_TYPE en; \
-	pthread_spin_lock(&c->spin);	\
-	for (en=0; en < c->nmax; en++)	\
+	for (int k=0; k<CACHE_NCHUNKS; k++)	\
 	{	\
-		c->cache[en] = (TYPE) 0;	\
-		c->ticky[en] = false;	\
+		TYPE *chunk = __atomic_load_n(&c->chunk[k], __ATOMIC_ACQUIRE);	\
+		if (NULL == chunk) continue;	\
+		unsigned long size = ((unsigned long) CACHE_CHUNK) << k;	\
+		unsigned char *state = CACHE_STATE(chunk, size);	\
+		for (unsigned long en=0; en<size; en++)	\
+			__atomic_store_n(&state[en], CACHE_EMPTY, __ATOMIC_RELEASE);	\
+	}	\
+}
+
+/**
+ * TYPE_NAME##_d_cache_prefill - store a whole range of values
+ * Same as calling store() for each, but looks up each chunk once.
+ */
+#define CACHE_PREFILL(TYPE_NAME,TYPE,IDX_TYPE) \
+void TYPE_NAME##_one_d_cache_prefill(TYPE_NAME##_cache *c,	\
+                    const TYPE *vals, IDX_TYPE lo, IDX_TYPE hi)	\
+{	\
+	if (c->disabled) return;	\
+	IDX_TYPE n = lo;	\
+	while (n < hi)	\
+	{	\
+		int k; unsigned long off, size;	\
+		if (!cache_locate(n, &k, &off, &size)) return;	\
+		TYPE *chunk = TYPE_NAME##_get_chunk(c, k, size);	\
+		unsigned char *state = CACHE_STATE(chunk, size);	\
+		for (; off < size && n < hi; off++, n++)	\
+		{	\
+			unsigned char expect = CACHE_EMPTY;	\
+			if (!__atomic_compare_exchange_n(&state[off], &expect,	\
+			      CACHE_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))	\
+				continue;	\
+			chunk[off] = vals[n-lo];	\
+			__atomic_store_n(&state[off], CACHE_READY, __ATOMIC_RELEASE);	\
+		}	\
 	}	\
-	pthread_spin_unlock(&c->spin);	\
 }
 
 /* =============================================================== */
 
 #define DEFINE_CACHE(TYPE_NAME,TYPE,IDX_TYPE) \
+		  CACHE_GET_CHUNK(TYPE_NAME,TYPE,IDX_TYPE) \
 		  CACHE_CHECK(TYPE_NAME,TYPE,IDX_TYPE) \
 		  CACHE_FETCH(TYPE_NAME,TYPE,IDX_TYPE) \
 		  CACHE_STORE(TYPE_NAME,TYPE,IDX_TYPE) \
-		  CACHE_CLEAR(TYPE_NAME,TYPE,IDX_TYPE)
+		  CACHE_CLEAR(TYPE_NAME,TYPE,IDX_TYPE) \
+		  CACHE_PREFILL(TYPE_NAME,TYPE,IDX_TYPE)
 
 DEFINE_CACHE(ld, long double, unsigned int)
 DEFINE_CACHE(cplx, complex, unsigned int)
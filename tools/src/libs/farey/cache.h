@@ -2,7 +2,16 @@
  * cache.h
  * Generic cache management for frequently requested numbers.
  *
+ * The caches are append-only arrays, grown in chunks that are never
+ * moved or freed. Each entry has a state byte that is published with
+ * an atomic store after the value is written, so that readers never
+ * take a lock: check() and fetch() are wait-free. A chunk is
+ * allocated on first store, and installed with a compare-and-swap.
+ * The first store to an entry wins; later stores of the same entry
+ * are ignored until the cache is cleared.
+ *
  * Linas Vepstas 2005,2006
+ * Lock-free rewrite October 2026
  */
 
 #include <complex.h>
@@ -14,23 +23,23 @@
 extern "C" {
 #endif
 
+/* Chunk k holds CACHE_CHUNK * 2^k entries, so that CACHE_NCHUNKS
+ * chunks cover indexes up to CACHE_CHUNK * 2^CACHE_NCHUNKS. Larger
+ * indexes are never cached. */
+#define CACHE_CHUNK 1024
+#define CACHE_NCHUNKS 40
+
 /* ======================================================================= */
 /* Cache management - long double. */
 
 typedef struct {
-	unsigned int nmax;
-	long double *cache;
-	bool *ticky;
+	long double *chunk[CACHE_NCHUNKS];
 	bool disabled;
-	pthread_spinlock_t spin;
 } ld_cache;
 
 
 #define DECLARE_LD_CACHE(name)         \
-	static ld_cache name = {.nmax=0, .cache=NULL, .ticky=NULL, \
-		.disabled = false }; \
-	__attribute__((constructor)) void name##_init(void) { \
-	pthread_spin_init(&name.spin, 0); }
+	static ld_cache name = {.disabled = false};
 
 /** ld_one_d_cache_check() -- check if long double value is in the cache
  *  Returns true if the value is in the cache, else returns false.
@@ -53,6 +62,13 @@ void ld_one_d_cache_store(ld_cache *c, long double val, unsigned int n);
  */
 void ld_one_d_cache_clear(ld_cache *c);
 
+/**
+ * ld_one_d_cache_prefill - store vals[n-lo] for all lo <= n < hi.
+ * Much cheaper than calling store() once per entry.
+ */
+void ld_one_d_cache_prefill(ld_cache *c, const long double *vals,
+                            unsigned int lo, unsigned int hi);
+
 /* ======================================================================= */
 /* Cache management - double complex. */
 
@@ -60,19 +76,13 @@ void ld_one_d_cache_clear(ld_cache *c);
 #define complex _Complex
 
 typedef struct {
-	unsigned int nmax;
-	complex *cache;
-	bool *ticky;
+	complex *chunk[CACHE_NCHUNKS];
 	bool disabled;
-	pthread_spinlock_t spin;
 } cplx_cache;
 
 
 #define DECLARE_CPX_CACHE(name)         \
-	static cplx_cache name = {.nmax=0, .cache=NULL, .ticky=NULL, \
-		.disabled = false }; \
-	__attribute__((constructor)) void name##_init(void) { \
-	pthread_spin_init(&name.spin, 0); }
+	static cplx_cache name = {.disabled = false};
 
 /** cplx_one_d_cache_check() -- check if double complex value is in the cache
  *  Returns true if the value is in the cache, else returns false.
@@ -95,22 +105,23 @@ void cplx_one_d_cache_store(cplx_cache *c, complex val, unsigned int n);
  */
 void cplx_one_d_cache_clear(cplx_cache *c);
 
+/**
+ * cplx_one_d_cache_prefill - store vals[n-lo] for all lo <= n < hi.
+ * Much cheaper than calling store() once per entry.
+ */
+void cplx_one_d_cache_prefill(cplx_cache *c, const complex *vals,
+                              unsigned int lo, unsigned int hi);
+
 /* ======================================================================= */
 /* Cache management -- unsigned int */
 
 typedef struct {
-	unsigned int nmax;
-	unsigned int *cache;
-	bool *ticky;
+	unsigned int *chunk[CACHE_NCHUNKS];
 	bool disabled;
-	pthread_spinlock_t spin;
 } ui_cache;
 
 #define DECLARE_UI_CACHE(name)         \
-	static ui_cache name = {.nmax=0, .cache=NULL, .ticky=NULL, \
-		.disabled = false, }; \
-	__attribute__((constructor)) void name##_init(void) { \
-	pthread_spin_init(&name.spin, 0); }
+	static ui_cache name = {.disabled = false};
 
 /** ui_one_d_cache_check() -- check if the uint value is in the cache.
  *  Returns true if the value is in the cache, else returns false.
@@ -133,22 +144,23 @@ void ui_one_d_cache_store(ui_cache *c, unsigned int val, unsigned int n);
  */
 void ui_one_d_cache_clear(ui_cache *c);
 
+/**
+ * ui_one_d_cache_prefill - store vals[n-lo] for all lo <= n < hi.
+ * Much cheaper than calling store() once per entry.
+ */
+void ui_one_d_cache_prefill(ui_cache *c, const unsigned int *vals,
+                            unsigned int lo, unsigned int hi);
+
 /* ======================================================================= */
 /* Cache management -- unsigned long */
 
 typedef struct {
-	unsigned long nmax;
-	unsigned long *cache;
-	bool *ticky;
+	unsigned long *chunk[CACHE_NCHUNKS];
 	bool disabled;
-	pthread_spinlock_t spin;
 } ul_cache;
 
 #define DECLARE_UL_CACHE(name)         \
-	static ul_cache name = {.nmax=0, .cache=NULL, .ticky=NULL, \
-		.disabled = false, }; \
-	__attribute__((constructor)) void name##_init(void) { \
-	pthread_spin_init(&name.spin, 0); }
+	static ul_cache name = {.disabled = false};
 
 /** ul_one_d_cache_check() -- check if the ulong value is in the cache.
  *  Returns true if the value is in the cache, else returns false.
@@ -171,22 +183,23 @@ void ul_one_d_cache_store(ul_cache *c, unsigned long val, unsigned long n);
  */
 void ul_one_d_cache_clear(ul_cache *c);
 
+/**
+ * ul_one_d_cache_prefill - store vals[n-lo] for all lo <= n < hi.
+ * Much cheaper than calling store() once per entry.
+ */
+void ul_one_d_cache_prefill(ul_cache *c, const unsigned long *vals,
+                            unsigned long lo, unsigned long hi);
+
 /* ======================================================================= */
 /* Cache management -- unsigned long long */
 
 typedef struct {
-	unsigned __int128 nmax;
-	unsigned __int128 *cache;
-	bool *ticky;
+	unsigned __int128 *chunk[CACHE_NCHUNKS];
 	bool disabled;
-	pthread_spinlock_t spin;
 } ull_cache;
 
 #define DECLARE_ULL_CACHE(name)         \
-	static ull_cache name = {.nmax=0, .cache=NULL, .ticky=NULL, \
-		.disabled = false, }; \
-	__attribute__((constructor)) void name##_init(void) { \
-	pthread_spin_init(&name.spin, 0); }
+	static ull_cache name = {.disabled = false};
 
 /** ull_one_d_cache_check() -- check if the u__int128 value is in the cache.
  *  Returns true if the value is in the cache, else returns false.
@@ -209,6 +222,13 @@ void ull_one_d_cache_store(ull_cache *c, unsigned __int128 val, unsigned int n);
  */
 void ull_one_d_cache_clear(ull_cache *c);
 
+/**
+ * ull_one_d_cache_prefill - store vals[n-lo] for all lo <= n < hi.
+ * Much cheaper than calling store() once per entry.
+ */
+void ull_one_d_cache_prefill(ull_cache *c, const unsigned __int128 *vals,
+                             unsigned int lo, unsigned int hi);
+
 /* ======================================================================= */
 
 #ifdef __cplusplus
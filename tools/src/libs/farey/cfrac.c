@@ -0,0 +1,31 @@
+/*
+ * cfrac.c
+ *
+ * Array versions of the continued-fraction kernel in cfrac.h.
+ *
+ * The expansion of each x stops after its own number of terms, so
+ * there is nothing to gain from vector lanes; but with the kernel
+ * inlined, and no shared state, the compiler is free to overlap the
+ * divides of neighbouring elements, and callers can hand slices of
+ * one array to different threads.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include "cfrac.h"
+
+void cf_question_mark_v (double *out, const double *x, size_t n)
+{
+	size_t i;
+	for (i=0; i<n; i++)
+		out[i] = cf_question_mark (x[i]);
+}
+
+void cf_question_inverse_v (double *out, const double *y, size_t n)
+{
+	size_t i;
+	for (i=0; i<n; i++)
+		out[i] = cf_question_inverse (y[i]);
+}
+
+/* ---------------------- END OF FILE ------------------------- */
@@ -0,0 +1,304 @@
+/*
+ * FILE:
+ * cfrac.h
+ *
+ * Reentrant continued-fraction kernel: real to continued fraction,
+ * the Minkowski question mark ?(x), and its inverse.
+ *
+ * The ContinuedFraction class in Farey.h keeps its expansion, and
+ * some scratch space, inside the object, so one object can't be
+ * shared between threads. Everything here works on a small cf_terms
+ * struct that the caller keeps on the stack, or on nothing at all,
+ * so the functions can be called from any number of threads. They
+ * are inline, and, when compiled as C++14 or later, constexpr.
+ *
+ * The conversions follow the ones in Farey.C: a real is first
+ * rounded to a ratio n / (2^31-1), and ?(x) is assembled 32 bits at
+ * a time, so cf_question_mark() returns what ContinuedFraction::
+ * SetReal() followed by ToFarey() returns.
+ *
+ * HISTORY:
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __CFRAC_H__
+#define __CFRAC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus) && (201402L <= __cplusplus)
+#define CF_CONSTEXPR constexpr
+#else
+#define CF_CONSTEXPR
+#endif
+
+#define CF_INLINE static inline CF_CONSTEXPR
+
+#define CF_MAX_TERMS 36
+
+/* Cutoffs for the expansion of ratios: stop when the remainder is
+ * less than 2^-cutoff of the divisor. Reals are only good to about
+ * 20 bits once rounded to n / (2^31-1). */
+#define CF_RATIO_CUTOFF 29
+#define CF_REAL_CUTOFF 20
+
+typedef struct
+{
+	int intpart;          /* integer part of the number */
+	unsigned int num;     /* fractional part is num / denom */
+	unsigned int denom;
+	int nterms;           /* number of partial quotients */
+	int a[CF_MAX_TERMS];  /* partial quotients, zero-terminated */
+} cf_terms;
+
+/**
+ * cf_expand -- expand the fraction cf->num / cf->denom, which must be
+ * less than one, into cf->a.  Quotients past the point where the
+ * remainder drops below 2^-cutoff of the divisor are dropped. If
+ * evenize is set, the expansion is rewritten, if need be, to have an
+ * even number of terms, as ?(x) wants.
+ */
+CF_INLINE void cf_expand (cf_terms *cf, int cutoff, int evenize)
+{
+	int i = 0;
+	for (i=0; i<CF_MAX_TERMS; i++) cf->a[i] = 0;
+
+	unsigned int n = cf->num;
+	unsigned int d = cf->denom;
+	if (0 != n)
+	{
+		/* Go to max-2, so that evenize has room. */
+		for (i=0; i<CF_MAX_TERMS-2; i++)
+		{
+			unsigned int m = d/n;
+			cf->a[i] = m;
+			d -= m*n;
+			m = d;
+			d = n;
+			n = m;
+
+			/* Clamp for "virtually zero". A trailing 1 is folded
+			 * into the term before it. */
+			if ((d>>cutoff) > n)
+			{
+				n = 0;
+				if (1 == cf->a[i])
+				{
+					if (0 != i)
+					{
+						cf->a[i] = 0;
+						cf->a[i-1] ++;
+						i--;
+					}
+					else
+					{
+						/* The fraction is a hair below one. */
+						cf->intpart ++;
+						cf->num = 0;
+						cf->a[0] = 0;
+						break;
+					}
+				}
+			}
+
+			if (0 == n)
+			{
+				if (evenize && 0 == i%2)
+				{
+					cf->a[i] -= 1;
+					cf->a[i+1] = 1;
+				}
+				break;
+			}
+		}
+	}
+
+	for (i=0; i<CF_MAX_TERMS-2; i++) if (0 == cf->a[i]) break;
+	cf->nterms = i;
+	cf->a[i+1] = 0;
+}
+
+/**
+ * cf_ratio_terms -- continued fraction of num/denom, num >= 0.
+ */
+CF_INLINE void cf_ratio_terms (cf_terms *cf, unsigned int num,
+                               unsigned int denom, int evenize)
+{
+	cf->intpart = num / denom;
+	cf->num = num % denom;
+	cf->denom = denom;
+	cf_expand (cf, CF_RATIO_CUTOFF, evenize);
+}
+
+/**
+ * cf_real_terms -- continued fraction of x.
+ */
+CF_INLINE void cf_real_terms (cf_terms *cf, double x, int evenize)
+{
+	int ip = (int) x;
+	if (0.0 > x) ip--;
+	double frac = x - (double) ip;
+
+	cf->intpart = ip;
+	cf->denom = 0x7fffffff;
+	cf->num = (int) (frac * (double) cf->denom);
+	cf_expand (cf, CF_REAL_CUTOFF, evenize);
+}
+
+/**
+ * cf_terms_to_real -- value of the continued fraction, evaluated
+ * from the last term back.
+ */
+CF_INLINE double cf_terms_to_real (const cf_terms *cf)
+{
+	double acc = 0.0;
+	int i = 0;
+	for (i=cf->nterms-1; 0<=i; i--)
+		acc = 1.0 / ((double) cf->a[i] + acc);
+	return acc + (double) cf->intpart;
+}
+
+/**
+ * cf_question -- ?(x) of an evenized expansion. The binary digits
+ * of ?(x) are runs of zeros and ones as long as the terms, the first
+ * run one short.
+ */
+CF_INLINE double cf_question (const cf_terms *cf)
+{
+	unsigned int f = 0;
+	unsigned int o = 0x80000000u;
+	int i = 0;
+	int j = 0;
+	while (i < 32)
+	{
+		int t = cf->a[j];
+		if (0 == j && 0 != cf->num) t--;
+
+		if (0 == j%2)
+			o = (t < 32) ? o >> t : 0;
+		else
+		{
+			int k = 0;
+			for (k=0; k<t && 0 != o; k++)
+			{
+				f |= o;
+				o >>= 1;
+			}
+		}
+		if (32 <= t) break;
+		i += t;
+		j++;
+		if (0 == cf->a[j]) break;
+	}
+
+	double tmp = 1.0 / (double) 0x7fffffff;
+	tmp *= 0.5;   /* since 0xffffffff hangs up on minus sign */
+	tmp *= (double) f;
+	return tmp + (double) cf->intpart;
+}
+
+/**
+ * cf_question_mark -- Minkowski ?(x). The integer part of x is
+ * passed through: ?(n+x) = n + ?(x).
+ */
+CF_INLINE double cf_question_mark (double x)
+{
+	cf_terms cf = {0};
+	cf_real_terms (&cf, x, 1);
+	return cf_question (&cf);
+}
+
+/**
+ * cf_question_ratio -- ?(num/denom).
+ */
+CF_INLINE double cf_question_ratio (unsigned int num, unsigned int denom)
+{
+	cf_terms cf = {0};
+	cf_ratio_terms (&cf, num, denom, 1);
+	return cf_question (&cf);
+}
+
+/**
+ * cf_question_inverse -- the inverse of ?(x), to double precision.
+ * The integer part is passed through, as for cf_question_mark().
+ *
+ * The binary expansion of y is read off as runs: a run of n zeros
+ * before the first one gives the term n+1, and each run of ones or
+ * zeros after that the next term. The convergents are accumulated
+ * front to back, so no terms need be stored. Exact in 64 bits: the
+ * runs after the first add up to at most 53.
+ */
+CF_INLINE double cf_question_inverse (double y)
+{
+	int ip = (int) y;
+	if ((double) ip > y) ip--;
+	y -= (double) ip;
+	if (0.0 >= y) return (double) ip;
+
+	/* Leading zeros, then the 53 bits of the mantissa. */
+	int z = 0;
+	while (y < 2.3283064365386963e-10)
+	{
+		y *= 4294967296.0;
+		z += 32;
+	}
+	while (y < 0.5)
+	{
+		y *= 2.0;
+		z++;
+	}
+	uint64_t m = (uint64_t) (y * 9007199254740992.0);
+
+	uint64_t p0 = 1, q0 = 0;
+	uint64_t p1 = 0, q1 = 1;
+	uint64_t a = z + 1;
+	int b = 52;
+	int ones = 1;
+	while (1)
+	{
+		uint64_t p = a*p1 + p0;
+		uint64_t q = a*q1 + q0;
+		p0 = p1; q0 = q1;
+		p1 = p; q1 = q;
+		if (0 == m) break;
+
+		a = 0;
+		if (ones)
+		{
+			while (0 <= b && ((m >> b) & 1))
+			{
+				m &= ~(((uint64_t) 1) << b);
+				b--;
+				a++;
+			}
+		}
+		else
+		{
+			while (0 == ((m >> b) & 1))
+			{
+				b--;
+				a++;
+			}
+		}
+		ones = !ones;
+	}
+	return (double) p1 / (double) q1 + (double) ip;
+}
+
+#ifdef   __cplusplus
+extern "C" {
+#endif
+
+/**
+ * cf_question_mark_v, cf_question_inverse_v -- the same, for arrays.
+ * out[i] = ?(x[i]) for 0 <= i < n; out and x may be the same array.
+ */
+void cf_question_mark_v (double *out, const double *x, size_t n);
+void cf_question_inverse_v (double *out, const double *y, size_t n);
+
+#ifdef   __cplusplus
+};
+#endif
+
+#endif /* __CFRAC_H__ */
@@ -9,14 +9,18 @@
  * Updates July 2006
  * Updates November 2014
  * Updates October 2016
+ * Sieve-backed mertens_m October 2026
  */
 
 #include <math.h>
 #include <malloc.h>
+#include <pthread.h>
+#include <stdlib.h>
 
 #include "gcf.h"
 #include "moebius.h"
 #include "cache.h"
+#include "sieve.h"
 
 /* ====================================================== */
 
@@ -383,15 +387,32 @@ long moebius_mu (long n)
 
 /* ====================================================== */
 
+/* Prefix sums of mu, filled in by the range sieve. The table only
+ * ever grows; old tables are leaked, not freed, since another thread
+ * may still be reading one. */
+static pthread_mutex_t mertens_mtx = PTHREAD_MUTEX_INITIALIZER;
+static long *mertens_tab = NULL;
+static long mertens_max = 0;
+
 long mertens_m (long n)
 {
-	long i;
-	long acc = 0;
-	for (i=1; i<=n; i++)
+	if (1 > n) return 0;
+	if (n < __atomic_load_n (&mertens_max, __ATOMIC_ACQUIRE))
+		return __atomic_load_n (&mertens_tab, __ATOMIC_ACQUIRE)[n];
+
+	pthread_mutex_lock (&mertens_mtx);
+	if (mertens_max <= n)
 	{
-		acc += moebius_mu (i);
+		long max = 2*n;
+		if (max < 65536) max = 65536;
+		long *tab = (long *) malloc (max * sizeof (long));
+		tab[0] = 0;
+		mertens_m_range (&tab[1], 1, max);
+		__atomic_store_n (&mertens_tab, tab, __ATOMIC_RELEASE);
+		__atomic_store_n (&mertens_max, max, __ATOMIC_RELEASE);
 	}
-	return acc;
+	pthread_mutex_unlock (&mertens_mtx);
+	return mertens_tab[n];
 }
 
 /* ====================================================== */
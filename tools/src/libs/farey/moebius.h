@@ -70,7 +70,10 @@ unsigned __int128 partitionll (long n);
 /** classic Moebius mu function */
 long moebius_mu (long n);
 
-/** Mertens function, summatory function of mu */
+/**
+ * Mertens function, summatory function of mu. The first call sieves
+ * a table out to 2n; after that, lookups are O(1). Thread-safe.
+ */
 long mertens_m (long n);
 
 /** Carmichael's lambda function (the funny variant on totient) */
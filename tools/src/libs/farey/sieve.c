@@ -0,0 +1,328 @@
+/*
+ * sieve.c
+ *
+ * Segmented sieve for the classic arithmetic functions.
+ * See sieve.h for an overview.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "moebius.h"
+#include "sieve.h"
+
+/* Number of integers per block. Sized so that the block's scratch
+ * (remainders plus the requested outputs) stays in L2 cache. */
+#define SIEVE_BLOCK 16384
+
+/* ====================================================== */
+/* Return an array of all primes p with p*p < hi, terminated by zero.
+ * Plain sieve of Eratosthenes; this is tiny compared to the range. */
+
+static unsigned long * base_primes (long hi)
+{
+	unsigned long max = 2;
+	while (max*max < (unsigned long) hi) max++;
+
+	char *comp = (char *) calloc (max+1, 1);
+	unsigned long *primes = (unsigned long *) malloc ((max+1) * sizeof (unsigned long));
+	unsigned long np = 0;
+	for (unsigned long p=2; p<=max; p++)
+	{
+		if (comp[p]) continue;
+		primes[np++] = p;
+		for (unsigned long m=p*p; m<=max; m+=p) comp[m] = 1;
+	}
+	primes[np] = 0;
+	free (comp);
+	return primes;
+}
+
+/* ====================================================== */
+/* Record that prime p divides n=lo+i exactly e times, with pk=p^e. */
+
+static inline void
+apply_prime (arith_sieve *s, long i, unsigned long p, int e, unsigned long pk)
+{
+	if (s->mu) s->mu[i] = (1 < e) ? 0 : -s->mu[i];
+	if (s->phi) s->phi[i] *= (p-1) * (pk/p);
+	if (s->omega) s->omega[i] ++;
+	if (s->Omega) s->Omega[i] += e;
+	if (s->lambda && (e%2)) s->lambda[i] = -s->lambda[i];
+	if (s->sigma)
+	{
+		long k = s->sigma_k;
+		if (0 == k) s->sigma[i] *= e+1;
+		else s->sigma[i] *= (ipow(p, k*(e+1)) - 1) / (ipow(p, k) - 1);
+	}
+	if (s->gpf) s->gpf[i] = p;
+	if (s->spf && 1 == s->spf[i]) s->spf[i] = p;
+}
+
+static void
+fill_block (arith_sieve *s, const unsigned long *primes,
+            unsigned long *rem, long lo, long blo, long bhi)
+{
+	long len = bhi - blo;
+	long off = blo - lo;
+
+	/* Shift the output pointers so that they index from blo. */
+	arith_sieve b = *s;
+	if (b.mu) b.mu += off;
+	if (b.phi) b.phi += off;
+	if (b.omega) b.omega += off;
+	if (b.Omega) b.Omega += off;
+	if (b.lambda) b.lambda += off;
+	if (b.Lambda) b.Lambda += off;
+	if (b.sigma) b.sigma += off;
+	if (b.gpf) b.gpf += off;
+	if (b.spf) b.spf += off;
+
+	for (long i=0; i<len; i++)
+	{
+		rem[i] = blo + i;
+		if (b.mu) b.mu[i] = 1;
+		if (b.phi) b.phi[i] = 1;
+		if (b.omega) b.omega[i] = 0;
+		if (b.Omega) b.Omega[i] = 0;
+		if (b.lambda) b.lambda[i] = 1;
+		if (b.sigma) b.sigma[i] = 1;
+		if (b.gpf) b.gpf[i] = 1;
+		if (b.spf) b.spf[i] = 1;
+	}
+
+	/* Cross off the small primes. Primes come in increasing order,
+	 * so the last one to hit a given n is its largest small factor. */
+	for (const unsigned long *pp = primes; *pp; pp++)
+	{
+		unsigned long p = *pp;
+		unsigned long start = ((blo + p - 1) / p) * p;
+		for (unsigned long m = start; m < (unsigned long) bhi; m += p)
+		{
+			long i = m - blo;
+			int e = 0;
+			unsigned long pk = 1;
+			while (0 == rem[i] % p)
+			{
+				rem[i] /= p;
+				pk *= p;
+				e++;
+			}
+			apply_prime (&b, i, p, e, pk);
+		}
+	}
+
+	/* Whatever is left over is a single prime larger than sqrt(hi). */
+	for (long i=0; i<len; i++)
+	{
+		if (1 < rem[i]) apply_prime (&b, i, rem[i], 1, rem[i]);
+
+		/* n is a prime power exactly when it has one distinct factor. */
+		if (b.Lambda)
+			b.Lambda[i] = (1 == b.omega[i]) ? logl ((long double) b.gpf[i]) : 0.0L;
+	}
+}
+
+void arith_sieve_fill (arith_sieve *s, long lo, long hi)
+{
+	if (hi <= lo) return;
+	if (lo < 1) lo = 1;
+
+	/* Lambda needs omega and gpf to decide if n is a prime power;
+	 * borrow scratch space if the caller did not ask for them.
+	 * fill_block() relies on these always being present. */
+	arith_sieve w = *s;
+	long *omega_tmp = NULL;
+	unsigned long *gpf_tmp = NULL;
+	if (w.Lambda && !w.omega)
+	{
+		omega_tmp = (long *) malloc ((hi-lo) * sizeof (long));
+		w.omega = omega_tmp;
+	}
+	if (w.Lambda && !w.gpf)
+	{
+		gpf_tmp = (unsigned long *) malloc ((hi-lo) * sizeof (unsigned long));
+		w.gpf = gpf_tmp;
+	}
+
+	unsigned long *primes = base_primes (hi);
+	unsigned long *rem = (unsigned long *) malloc (SIEVE_BLOCK * sizeof (unsigned long));
+
+	for (long blo = lo; blo < hi; blo += SIEVE_BLOCK)
+	{
+		long bhi = blo + SIEVE_BLOCK;
+		if (hi < bhi) bhi = hi;
+		fill_block (&w, primes, rem, lo, blo, bhi);
+	}
+
+	free (rem);
+	free (primes);
+	free (omega_tmp);
+	free (gpf_tmp);
+}
+
+/* ====================================================== */
+
+void moebius_mu_range (long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.mu = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void totient_phi_range (long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.phi = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void little_omega_range (long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.omega = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void big_omega_range (long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.Omega = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void liouville_lambda_range (long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.lambda = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void mangoldt_lambda_range (long double *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.Lambda = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void sigma_range (long *vals, long k, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.sigma = vals;
+	s.sigma_k = k;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void gpf_range (unsigned long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.gpf = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void smallest_prime_factor_range (unsigned long *vals, long lo, long hi)
+{
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.spf = vals;
+	arith_sieve_fill (&s, lo, hi);
+}
+
+void mertens_m_range (long *vals, long lo, long hi)
+{
+	if (hi <= lo) return;
+	if (lo < 1) lo = 1;
+
+	long *mu = (long *) malloc (SIEVE_BLOCK * sizeof (long));
+	long acc = 0;
+	for (long blo = 1; blo < hi; blo += SIEVE_BLOCK)
+	{
+		long bhi = blo + SIEVE_BLOCK;
+		if (hi < bhi) bhi = hi;
+		moebius_mu_range (mu, blo, bhi);
+		for (long n=blo; n<bhi; n++)
+		{
+			acc += mu[n-blo];
+			if (lo <= n) vals[n-lo] = acc;
+		}
+	}
+	free (mu);
+}
+
+/* ====================================================== */
+
+// #define TEST 1
+#ifdef TEST
+
+#include <stdio.h>
+#include "gpf.h"
+#include "totient.h"
+
+int main()
+{
+	long have_error = 0;
+	long lo = 1, hi = 200000;
+	long len = hi - lo;
+
+	arith_sieve s;
+	memset (&s, 0, sizeof (s));
+	s.mu = (long *) malloc (len * sizeof (long));
+	s.phi = (long *) malloc (len * sizeof (long));
+	s.omega = (long *) malloc (len * sizeof (long));
+	s.Omega = (long *) malloc (len * sizeof (long));
+	s.lambda = (long *) malloc (len * sizeof (long));
+	s.Lambda = (long double *) malloc (len * sizeof (long double));
+	s.sigma = (long *) malloc (len * sizeof (long));
+	s.sigma_k = 1;
+	s.gpf = (unsigned long *) malloc (len * sizeof (unsigned long));
+	s.spf = (unsigned long *) malloc (len * sizeof (unsigned long));
+	arith_sieve_fill (&s, lo, hi);
+
+	long mertens[len];
+	mertens_m_range (mertens, lo, hi);
+
+	long acc = 0;
+	for (long n=lo; n<hi; n++)
+	{
+		long i = n - lo;
+		acc += moebius_mu(n);
+		if (s.mu[i] != moebius_mu(n) ||
+		    s.phi[i] != totient_phi(n) ||
+		    s.omega[i] != little_omega(n) ||
+		    s.Omega[i] != big_omega(n) ||
+		    s.lambda[i] != liouville_lambda(n) ||
+		    s.Lambda[i] != mangoldt_lambda(n) ||
+		    s.sigma[i] != sigma(n, 1) ||
+		    s.gpf[i] != gpf(n) ||
+		    mertens[i] != acc)
+		{
+			printf ("ERROR: sieve mismatch at n=%ld\n", n);
+			have_error ++;
+		}
+		if (1 < n && (n % s.spf[i] || s.spf[i] > s.gpf[i]))
+		{
+			printf ("ERROR: bad smallest prime factor at n=%ld\n", n);
+			have_error ++;
+		}
+	}
+
+	if (0 == have_error)
+	{
+		printf ("PASS: tested arithmetic sieve up to %ld\n", hi);
+	}
+	return have_error;
+}
+#endif /* TEST */
+
+/* --------------------------- END OF FILE ------------------------- */
@@ -0,0 +1,78 @@
+/*
+ * sieve.h
+ *
+ * Segmented sieve for the classic arithmetic functions.
+ *
+ * Fills in mu, phi, omega, Omega, liouville lambda, mangoldt Lambda,
+ * sigma_k, the greatest and the smallest prime factor, for a whole
+ * range of integers [lo, hi) in one pass. The range is walked in
+ * cache-sized blocks; each block is crossed off by all primes up to
+ * sqrt(hi), so the cost is O((hi-lo) log log hi) for the whole range,
+ * instead of a trial division for each integer.
+ *
+ * The per-n functions in moebius.h, totient.h and gpf.h remain the
+ * right thing for isolated values; use this for whole tables.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __FAREY_SIEVE_H__
+#define __FAREY_SIEVE_H__
+
+#ifdef   __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Output arrays for arith_sieve_fill(). All arrays are indexed by
+ * n-lo, and must hold at least hi-lo entries. Any array may be NULL,
+ * in which case that function is not computed. The values agree
+ * with those returned by the per-n functions of the same name.
+ */
+typedef struct
+{
+	long *mu;              /* moebius_mu() */
+	long *phi;             /* totient_phi() */
+	long *omega;           /* little_omega(): distinct prime factors */
+	long *Omega;           /* big_omega(): prime factors w/ multiplicity */
+	long *lambda;          /* liouville_lambda() */
+	long double *Lambda;   /* mangoldt_lambda() */
+	long *sigma;           /* sigma(n, sigma_k) */
+	long sigma_k;
+	unsigned long *gpf;    /* gpf(): greatest prime factor */
+	unsigned long *spf;    /* smallest prime factor */
+} arith_sieve;
+
+/**
+ * arith_sieve_fill -- fill in the requested arithmetic functions
+ * for all n in the range lo <= n < hi. Requires 1 <= lo.
+ * Thread-safe; different threads may fill different ranges at the
+ * same time.
+ */
+void arith_sieve_fill (arith_sieve *s, long lo, long hi);
+
+/**
+ * Bulk versions of the per-n functions. Each fills vals[n-lo] for
+ * lo <= n < hi. These are thin wrappers around arith_sieve_fill().
+ */
+void moebius_mu_range (long *vals, long lo, long hi);
+void totient_phi_range (long *vals, long lo, long hi);
+void little_omega_range (long *vals, long lo, long hi);
+void big_omega_range (long *vals, long lo, long hi);
+void liouville_lambda_range (long *vals, long lo, long hi);
+void mangoldt_lambda_range (long double *vals, long lo, long hi);
+void sigma_range (long *vals, long k, long lo, long hi);
+void gpf_range (unsigned long *vals, long lo, long hi);
+void smallest_prime_factor_range (unsigned long *vals, long lo, long hi);
+
+/**
+ * mertens_m_range -- the Mertens function M(n) = sum_{k<=n} mu(k),
+ * for lo <= n < hi. Runs the sieve from 1, so costs O(hi).
+ */
+void mertens_m_range (long *vals, long lo, long hi);
+
+#ifdef   __cplusplus
+};
+#endif
+
+#endif /* __FAREY_SIEVE_H__ */
@@ -0,0 +1,284 @@
+/*
+ * stern-brocot.h
+ *
+ * Exact walks down the Stern-Brocot tree, to any depth.
+ *
+ * stern_brocot_tree() in stern-brocot.c, and dyadic_to_stern_brocot()
+ * and question_inverse() in question-new.c, stop at 64 bits: an
+ * unsigned long, or the mantissa of a long double. The walker here is
+ * a template on the integer type, so that the same code runs with
+ *    unsigned long       to depth 64
+ *    unsigned __int128   to depth 128
+ *    mpz_class           to any depth (include <gmpxx.h> first, and
+ *                        link with -lgmpxx -lgmp)
+ * and SternBrocotInt<LEVEL>::type picks the narrowest of these that
+ * will hold a given depth, at compile time.
+ *
+ * The dyadic N / 2^level, 0 <= N < 2^level, is the left end of the
+ * level'th subdivision of the unit interval; read off the bits of N,
+ * top bit first, and for each one replace the left (bit 1) or the
+ * right (bit 0) end of the interval [0/1, 1/1] with the mediant of
+ * the two. The left end after all the bits is ?^-1(N / 2^level).
+ * The walker keeps the intervals for every depth, so that going to
+ * a nearby N only re-walks from the first bit that differs: stepping
+ * across a grid of consecutive N is two steps per point, on average,
+ * instead of level steps.
+ *
+ * Linas Vepstas October 2026
+ */
+
+#ifndef __STERN_BROCOT_H__
+#define __STERN_BROCOT_H__
+
+#include <stddef.h>
+#include <type_traits>
+#include <vector>
+
+/* ------------------------------------------------------------------ */
+/* Bit twiddling for each of the integer types. */
+
+template<typename INT> struct SternBrocotTraits;
+
+template<> struct SternBrocotTraits<unsigned long>
+{
+	static const int max_level = 64;
+	static int top_bit (unsigned long n)
+	{
+		return n ? 63 - __builtin_clzl (n) : -1;
+	}
+	static int bit (unsigned long n, int i) { return (n >> i) & 1; }
+	static unsigned long to_ulong (unsigned long n) { return n; }
+	static long double ratio (unsigned long p, unsigned long q)
+	{
+		return ((long double) p) / ((long double) q);
+	}
+};
+
+template<> struct SternBrocotTraits<unsigned __int128>
+{
+	static const int max_level = 128;
+	static int top_bit (unsigned __int128 n)
+	{
+		unsigned long hi = n >> 64;
+		if (hi) return 127 - __builtin_clzl (hi);
+		return SternBrocotTraits<unsigned long>::top_bit ((unsigned long) n);
+	}
+	static int bit (unsigned __int128 n, int i) { return (n >> i) & 1; }
+	static unsigned long to_ulong (unsigned __int128 n) { return n; }
+	static long double ratio (unsigned __int128 p, unsigned __int128 q)
+	{
+		return ((long double) p) / ((long double) q);
+	}
+};
+
+#ifdef __GMP_PLUSPLUS__
+template<> struct SternBrocotTraits<mpz_class>
+{
+	static const int max_level = 0x7fffffff;
+	static int top_bit (const mpz_class &n)
+	{
+		return (0 == sgn (n)) ? -1 : mpz_sizeinbase (n.get_mpz_t(), 2) - 1;
+	}
+	static int bit (const mpz_class &n, int i)
+	{
+		return mpz_tstbit (n.get_mpz_t(), i);
+	}
+	static unsigned long to_ulong (const mpz_class &n) { return n.get_ui(); }
+	/* p and q can be too big for a long double, but their ratio is
+	 * not; keep the top 64 bits of each. Here p <= q. */
+	static long double ratio (const mpz_class &p, const mpz_class &q)
+	{
+		long sh = top_bit (q) - 63;
+		if (sh <= 0)
+			return ((long double) p.get_ui()) / ((long double) q.get_ui());
+		mpz_class ps = p >> sh;
+		mpz_class qs = q >> sh;
+		return ((long double) ps.get_ui()) / ((long double) qs.get_ui());
+	}
+};
+#endif
+
+/* The integer type for a given depth. */
+template<int LEVEL> struct SternBrocotInt
+{
+#ifdef __GMP_PLUSPLUS__
+	typedef typename std::conditional<LEVEL <= 64, unsigned long,
+	        typename std::conditional<LEVEL <= 128, unsigned __int128,
+	                                  mpz_class>::type>::type type;
+#else
+	static_assert (LEVEL <= 128, "include <gmpxx.h> for depths past 128");
+	typedef typename std::conditional<LEVEL <= 64, unsigned long,
+	                                  unsigned __int128>::type type;
+#endif
+};
+
+/* ------------------------------------------------------------------ */
+
+template<typename INT>
+class SternBrocotWalker
+{
+	public:
+		SternBrocotWalker (int level);
+
+		/* Walk to N / 2^level. */
+		void Seek (const INT &N);
+		/* Walk to (N+1) / 2^level. */
+		void Next (void);
+
+		int GetLevel (void) { return level; }
+		const INT & GetN (void) { return n; }
+
+		/* ?^-1(N / 2^level) = p/q */
+		const INT & GetNum (void) { return pl[level]; }
+		const INT & GetDenom (void) { return ql[level]; }
+		long double ToReal (void)
+		{
+			return SternBrocotTraits<INT>::ratio (pl[level], ql[level]);
+		}
+
+	private:
+		typedef SternBrocotTraits<INT> Traits;
+
+		int level;
+		INT n;
+		int depth;      /* the intervals are good down to this depth */
+
+		/* The interval pl/ql .. pr/qr after d bits. */
+		std::vector<INT> pl, ql, pr, qr;
+};
+
+template<typename INT>
+SternBrocotWalker<INT>::SternBrocotWalker (int lvl)
+	: level (lvl), n (0), depth (0),
+	  pl (lvl+1), ql (lvl+1), pr (lvl+1), qr (lvl+1)
+{
+	pl[0] = 0; ql[0] = 1;
+	pr[0] = 1; qr[0] = 1;
+	Seek (n);
+}
+
+template<typename INT>
+void SternBrocotWalker<INT>::Seek (const INT &N)
+{
+	/* The bits above the highest one that changed are the same path. */
+	int top = Traits::top_bit (N ^ n);
+	int keep = level - 1 - top;
+	if (keep < 0) keep = 0;
+	if (keep < depth) depth = keep;
+	n = N;
+
+	for (int d=depth; d<level; d++)
+	{
+		INT pm = pl[d] + pr[d];
+		INT qm = ql[d] + qr[d];
+		if (Traits::bit (n, level-1-d))
+		{
+			pl[d+1] = pm; ql[d+1] = qm;
+			pr[d+1] = pr[d]; qr[d+1] = qr[d];
+		}
+		else
+		{
+			pl[d+1] = pl[d]; ql[d+1] = ql[d];
+			pr[d+1] = pm; qr[d+1] = qm;
+		}
+	}
+	depth = level;
+}
+
+template<typename INT>
+void SternBrocotWalker<INT>::Next (void)
+{
+	INT N = n + 1;
+	Seek (N);
+}
+
+/* ------------------------------------------------------------------ */
+
+/**
+ * stern_brocot_grid -- ?^-1 at the count dyadics (start+k) / 2^level,
+ * 0 <= k < count, as exact ratios p[k]/q[k]. The last point may be
+ * 2^level / 2^level, which is 1/1, except when level is the full
+ * width of INT.
+ */
+template<typename INT>
+void stern_brocot_grid (int level, const INT &start, size_t count,
+                        INT *p, INT *q)
+{
+	SternBrocotWalker<INT> walk (level);
+	bool has_end = (level < SternBrocotTraits<INT>::max_level);
+	INT one = 1;
+	INT end = has_end ? (one << level) : one;
+	INT N = start;
+	for (size_t k=0; k<count; k++)
+	{
+		if (has_end && N == end) { p[k] = 1; q[k] = 1; break; }
+		walk.Seek (N);
+		p[k] = walk.GetNum();
+		q[k] = walk.GetDenom();
+		N = N + 1;
+	}
+}
+
+/**
+ * question_inverse_grid -- the same, rounded to long double.
+ */
+template<typename INT>
+void question_inverse_grid (int level, const INT &start, size_t count,
+                            long double *out)
+{
+	SternBrocotWalker<INT> walk (level);
+	bool has_end = (level < SternBrocotTraits<INT>::max_level);
+	INT one = 1;
+	INT end = has_end ? (one << level) : one;
+	INT N = start;
+	for (size_t k=0; k<count; k++)
+	{
+		if (has_end && N == end) { out[k] = 1.0L; break; }
+		walk.Seek (N);
+		out[k] = walk.ToReal();
+		N = N + 1;
+	}
+}
+
+/**
+ * question_mark_exact -- ?(p/q), exactly, as N / 2^level.
+ * For 0 <= p < q. With the partial quotients a_1..a_n of p/q, and
+ * s_k = a_1 + ... + a_k,
+ *    ?(p/q) = 2 sum_k (-1)^(k+1) 2^(-s_k),
+ * so level = s_n - 1. Returns false if that is deeper than INT holds.
+ */
+template<typename INT>
+bool question_mark_exact (const INT &p, const INT &q, INT &N, int &level)
+{
+	N = 0;
+	level = 0;
+	if (0 == p) return true;
+
+	/* The partial quotients, and their running sums. */
+	std::vector<long> sums;
+	INT a = q, b = p;
+	long s = 0;
+	while (0 != b)
+	{
+		INT t = a / b;
+		INT r = a - t*b;
+		if (SternBrocotTraits<INT>::max_level < t) return false;
+		s += SternBrocotTraits<INT>::to_ulong (t);
+		if (SternBrocotTraits<INT>::max_level <= s-1) return false;
+		sums.push_back (s);
+		a = b;
+		b = r;
+	}
+
+	level = s - 1;
+	INT one = 1;
+	for (size_t k=0; k<sums.size(); k++)
+	{
+		INT bit = one << (level + 1 - sums[k]);
+		if (0 == k%2) N = N + bit;
+		else N = N - bit;
+	}
+	return true;
+}
+
+#endif /* __STERN_BROCOT_H__ */
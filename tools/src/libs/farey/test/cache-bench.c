@@ -0,0 +1,117 @@
+/*
+ * cache-bench.c
+ *
+ * Contention microbenchmark for the number caches in cache.c.
+ * Each thread hammers the same cache with a read-mostly mix of
+ * check/fetch/store on pseudo-random indexes, the way the threaded
+ * renderers hit mangoldt_lambda_cached() and sigma_one(). Prints
+ * the aggregate throughput for 1, 2, 4, ... threads, and verifies
+ * that every fetched value is the one that was stored.
+ *
+ * Usage: cache-bench [range] [iterations-per-thread]
+ *
+ * Linas Vepstas October 2026
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cache.h"
+
+DECLARE_UL_CACHE(bench_cache);
+
+static unsigned long range = 1000000;
+static unsigned long niter = 20000000;
+
+typedef struct
+{
+	unsigned long seed;
+	unsigned long hits;
+	unsigned long errors;
+} bench_arg;
+
+static void * bench_thread (void *p)
+{
+	bench_arg *arg = (bench_arg *) p;
+	unsigned long x = arg->seed;
+	for (unsigned long i=0; i<niter; i++)
+	{
+		/* xorshift, good enough to scatter the indexes */
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		unsigned long n = x % range;
+
+		if (ul_one_d_cache_check (&bench_cache, n))
+		{
+			arg->hits ++;
+			if (n*n+1 != ul_one_d_cache_fetch (&bench_cache, n))
+				arg->errors ++;
+		}
+		else
+			ul_one_d_cache_store (&bench_cache, n*n+1, n);
+	}
+	return NULL;
+}
+
+static double now (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+int main (int argc, char *argv[])
+{
+	if (1 < argc) range = atol (argv[1]);
+	if (2 < argc) niter = atol (argv[2]);
+
+	int maxthreads = sysconf (_SC_NPROCESSORS_ONLN);
+	if (maxthreads < 1) maxthreads = 1;
+
+	printf ("#\n# range=%lu iterations/thread=%lu\n", range, niter);
+	printf ("# threads\tsecs\tMops/sec\thit-rate\n");
+
+	int have_error = 0;
+	for (int nthreads=1; nthreads <= maxthreads; nthreads *= 2)
+	{
+		ul_one_d_cache_clear (&bench_cache);
+
+		pthread_t thr[nthreads];
+		bench_arg args[nthreads];
+		double start = now();
+		for (int i=0; i<nthreads; i++)
+		{
+			args[i].seed = 0x9e3779b97f4a7c15UL * (i+1);
+			args[i].hits = 0;
+			args[i].errors = 0;
+			pthread_create (&thr[i], NULL, bench_thread, &args[i]);
+		}
+
+		unsigned long hits = 0;
+		unsigned long errors = 0;
+		for (int i=0; i<nthreads; i++)
+		{
+			pthread_join (thr[i], NULL);
+			hits += args[i].hits;
+			errors += args[i].errors;
+		}
+		double secs = now() - start;
+
+		double nops = ((double) nthreads) * niter;
+		printf ("%d\t%g\t%g\t%g\n", nthreads, secs,
+		        1.0e-6 * nops / secs, hits / nops);
+		fflush (stdout);
+
+		if (errors)
+		{
+			printf ("ERROR: %lu bad fetches with %d threads\n",
+			        errors, nthreads);
+			have_error ++;
+		}
+	}
+	return have_error;
+}